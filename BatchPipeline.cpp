@@ -0,0 +1,178 @@
+#include "BatchPipeline.h" // Include the declaration of the BatchPipeline class
+#include <chrono> // Include the chrono header for the sleeps of the waiting stages
+#include <thread> // Include the thread header for the solver and writer threads
+
+const int BatchPipeline::Slots;
+
+namespace {
+    // Take the oldest item of a ring, waiting while it is empty: the stage first yields to the others, then sleeps
+    // The time waited and the depth of the ring are added to the counters of the stage
+    template <typename Item>
+    Item take(SpscRing<Item>& ring, BatchPipeline::StageCounters& counters) {
+        Item item;
+        if (!ring.pop(item)) {
+            PhaseTimer timer(&counters.waitNanoseconds);
+            for (int attempts = 0; !ring.pop(item); attempts++) {
+                if (attempts < 64)
+                    std::this_thread::yield();
+                else
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        }
+        counters.sampleDepth(static_cast<long long>(ring.size()) + 1);
+        return item;
+    }
+
+    // Append an item to a ring; every ring has a place for every slot, so this only waits if that ever changes
+    template <typename Item>
+    void give(SpscRing<Item>& ring, Item item) {
+        while (!ring.push(item))
+            std::this_thread::yield();
+    }
+}
+
+std::string BatchPipeline::StageCounters::toJson(const char* stage, const char* queue) const {
+    // Throughputs are measured on the busy time, a stage that never waits is the bottleneck
+    double seconds = static_cast<double>(busyNanoseconds) * 1e-9;
+    char line[512];
+    std::snprintf(line, sizeof(line),
+                  "{\"stage\": \"%s\", \"instances\": %lld, \"cells\": %lld, \"bytes\": %lld, \"busy_ns\": %lld, "
+                  "\"wait_ns\": %lld, \"instances_per_second\": %.0f, \"cells_per_second\": %.0f, \"queue\": \"%s\", "
+                  "\"mean_depth\": %.2f, \"peak_depth\": %lld}",
+                  stage, instances, cells, bytes, busyNanoseconds, waitNanoseconds,
+                  seconds > 0 ? static_cast<double>(instances) / seconds : 0,
+                  seconds > 0 ? static_cast<double>(cells) / seconds : 0, queue,
+                  depthSamples > 0 ? static_cast<double>(depthSum) / static_cast<double>(depthSamples) : 0, peakDepth);
+    return line;
+}
+
+BatchPipeline::BatchPipeline(FILE* output, FILE* statsOutput, ParallelBfs* parallel)
+        : output(output), statsOutput(statsOutput), parallel(parallel), parsed(Slots), solved(Slots), freeSlots(Slots) {}
+
+bool BatchPipeline::run(BatchReader& reader, long long instances, std::string& error) {
+    // Every slot starts in the free ring, the rings are empty between runs
+    if (slots.empty())
+        slots.resize(Slots);
+    for (Slot& slot : slots)
+        give(freeSlots, &slot);
+    readerCounters = StageCounters();
+    solverCounters = StageCounters();
+    writerCounters = StageCounters();
+
+    std::thread solver(&BatchPipeline::solve, this);
+    std::thread writer(&BatchPipeline::write, this);
+
+    // Parse the instances into free slots; the marker follows the last one, or replaces the malformed one
+    bool valid = true;
+    {
+        PhaseTimer timer(&readerCounters.busyNanoseconds);
+        for (long long i = 0; i <= instances; i++) {
+            Slot* slot = take(freeSlots, readerCounters);
+            slot->last = i == instances;
+            if (!slot->last) {
+                long long n = 0, m = 0;
+                valid = reader.readDimensions(n, m, error);
+                if (valid) {
+                    slot->giant = n * m >= PackedGrid::MinimumCells;
+                    slot->cells = n * m;
+                    valid = slot->giant ? reader.readRows(slot->packed, n, m, error)
+                                        : reader.readRows(slot->grid, n, m, slot->start, slot->end, error);
+                }
+                slot->prisoners = reader.prisoners();
+                slot->exits = reader.exits();
+                slot->last = !valid;
+            }
+            // Once given, the slot belongs to the other stages: nothing of it is read afterwards
+            bool last = slot->last;
+            if (!last) {
+                readerCounters.instances++;
+                readerCounters.cells += slot->cells;
+            }
+            give(parsed, slot);
+            if (last)
+                break;
+        }
+    }
+    readerCounters.busyNanoseconds -= readerCounters.waitNanoseconds;
+
+    solver.join();
+    writer.join();
+
+    // The writer returned every slot but the marker, which it keeps: empty the free ring for the next run
+    Slot* slot;
+    while (freeSlots.pop(slot)) {
+    }
+    return valid;
+}
+
+void BatchPipeline::solve() {
+    // One set of search buffers decides every instance, in input order
+    Labyrinth::SearchBuffers buffers;
+    buffers.parallel = parallel;
+    {
+        PhaseTimer timer(&solverCounters.busyNanoseconds);
+        while (true) {
+            Slot* slot = take(parsed, solverCounters);
+            bool last = slot->last;
+            if (!last) {
+                if (statsOutput != nullptr) {
+                    slot->stats.clear();
+                    buffers.stats = &slot->stats;
+                }
+                if (slot->giant)
+                    slot->result.assign(1, slot->packed.escapeDecision(nullptr, buffers.stats));
+                else
+                    Labyrinth::decideInstance(slot->grid, slot->prisoners, slot->exits, slot->start, slot->end, buffers,
+                                              slot->result);
+                solverCounters.instances++;
+                solverCounters.cells += slot->cells;
+            }
+            give(solved, slot);
+            if (last)
+                break;
+        }
+    }
+    solverCounters.busyNanoseconds -= solverCounters.waitNanoseconds;
+}
+
+void BatchPipeline::write() {
+    // Results and statistics are gathered in blocks of 64 KiB, each written by one call
+    std::string out, statsOut;
+    out.reserve(1 << 16);
+    {
+        PhaseTimer timer(&writerCounters.busyNanoseconds);
+        while (true) {
+            Slot* slot = take(solved, writerCounters);
+            if (slot->last)
+                break;
+            out += slot->result;
+            out += '\n';
+            if (statsOutput != nullptr) {
+                statsOut += slot->stats.toJson(writerCounters.instances + 1, slot->result);
+                statsOut += '\n';
+            }
+            writerCounters.instances++;
+            writerCounters.cells += slot->cells;
+            give(freeSlots, slot);
+
+            if (out.size() >= (1 << 16)) {
+                std::fwrite(out.data(), 1, out.size(), output);
+                writerCounters.bytes += static_cast<long long>(out.size());
+                out.clear();
+            }
+            if (statsOut.size() >= (1 << 16)) {
+                std::fwrite(statsOut.data(), 1, statsOut.size(), statsOutput);
+                statsOut.clear();
+            }
+        }
+
+        std::fwrite(out.data(), 1, out.size(), output);
+        writerCounters.bytes += static_cast<long long>(out.size());
+        std::fflush(output);
+        if (statsOutput != nullptr) {
+            std::fwrite(statsOut.data(), 1, statsOut.size(), statsOutput);
+            std::fflush(statsOutput);
+        }
+    }
+    writerCounters.busyNanoseconds -= writerCounters.waitNanoseconds;
+}
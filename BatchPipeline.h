@@ -0,0 +1,100 @@
+#ifndef LABYRINTH_BATCHPIPELINE_H
+#define LABYRINTH_BATCHPIPELINE_H
+
+#include "Labyrinth.h" // Include the declaration of the Labyrinth class
+#include "BatchReader.h" // Include the declaration of the BatchReader class
+#include "PackedGrid.h" // Include the packed grid of the giant instances
+#include "SpscRing.h" // Include the lock-free rings between the stages
+#include <cstdio> // Buffered output of the results
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+
+// Three-stage pipeline of the batch mode: the calling thread parses the instances, a solver thread decides them
+// and a writer thread prints the results in blocks, so reading the input, solving and writing overlap.
+// The stages pass instance slots through single-producer single-consumer rings: parsed (reader to solver),
+// solved (solver to writer) and free (writer back to the reader). The slots and their grids are recycled, at most
+// Slots instances are held at once and the reader waits for a free slot when it runs ahead
+class BatchPipeline {
+public:
+    // Number of instance slots in flight
+    static const int Slots = 4;
+
+    // Counters of one stage
+    struct StageCounters {
+        long long instances = 0; // Instances handled
+        long long cells = 0; // Cells of the instances handled
+        long long bytes = 0; // Bytes of results written, writer only
+        long long busyNanoseconds = 0; // Time spent working
+        long long waitNanoseconds = 0; // Time spent waiting for the input ring
+        long long depthSamples = 0; // Items taken from the input ring
+        long long depthSum = 0; // Sum of the depths of the input ring seen when taking an item
+        long long peakDepth = 0; // Largest depth of the input ring seen when taking an item
+
+        // Record the depth of the input ring when an item is taken
+        void sampleDepth(long long depth) {
+            depthSamples++;
+            depthSum += depth;
+            if (depth > peakDepth)
+                peakDepth = depth;
+        }
+
+        // One JSON object on one line, without the line break: counters, throughput while busy and depths of the input ring
+        std::string toJson(const char* stage, const char* queue) const;
+    };
+
+    // Pipeline writing the results to output; when statsOutput is given, the statistics of every instance are written
+    // there as JSON lines, in input order. The solver searches large grids with parallel when it is not null
+    BatchPipeline(FILE* output, FILE* statsOutput = nullptr, ParallelBfs* parallel = nullptr);
+
+    // Parse, solve and write the given number of instances from the reader
+    // Return false and describe the problem in error if an instance is malformed, the results before it are still printed
+    bool run(BatchReader& reader, long long instances, std::string& error);
+
+    // Counters of the last run, the stage that waits least is the bottleneck
+    const StageCounters& reader() const {
+        return readerCounters;
+    }
+    const StageCounters& solver() const {
+        return solverCounters;
+    }
+    const StageCounters& writer() const {
+        return writerCounters;
+    }
+
+private:
+    // Instance travelling through the stages
+    struct Slot {
+        WeightedGraph::GridGraph grid; // Labels of the labyrinth, memory reused across instances
+        PackedGrid packed; // Cells of a giant instance, memory reused across instances
+        bool giant = false; // The instance is in packed rather than in grid
+        int start = 0; // Vertex number of the first prisoner
+        int end = 0; // Vertex number of the first exit
+        long long prisoners = 0; // Number of prisoners
+        long long exits = 0; // Number of exits
+        long long cells = 0; // Number of cells
+        std::string result; // One 'Y' or 'N' per prisoner once solved
+        SolverStats stats; // Statistics of the solve, only filled when they are written
+        bool last = false; // Marker following the last instance, or the malformed one, carries no instance
+    };
+
+    FILE* output; // Destination of the results
+    FILE* statsOutput; // Destination of the statistics, null when they are not collected
+    ParallelBfs* parallel; // Engine of the large grids, null for serial searches
+
+    std::vector<Slot> slots; // Every slot
+    SpscRing<Slot*> parsed; // Parsed instances, from the reader to the solver
+    SpscRing<Slot*> solved; // Decided instances, from the solver to the writer
+    SpscRing<Slot*> freeSlots; // Written slots, from the writer back to the reader
+
+    StageCounters readerCounters; // Counters of the reader, its input ring is freeSlots
+    StageCounters solverCounters; // Counters of the solver, its input ring is parsed
+    StageCounters writerCounters; // Counters of the writer, its input ring is solved
+
+    // Body of the solver thread: decide the parsed instances until the marker
+    void solve();
+
+    // Body of the writer thread: print the results in blocks until the marker
+    void write();
+};
+
+#endif //LABYRINTH_BATCHPIPELINE_H
@@ -0,0 +1,182 @@
+#include "BatchReader.h" // Include the declaration of the BatchReader class
+#include <cerrno> // Include the cerrno header for interrupted reads
+#include <fcntl.h> // Include the fcntl header for posix_fadvise
+#include <limits> // Include the limits header for numeric limits
+#include <unistd.h> // Include the unistd header for read
+
+const size_t BatchReader::BlockSize;
+const long long BatchReader::MaxDimension;
+
+BatchReader::BatchReader(int fd) : fd(fd), buffer(BlockSize) {
+    // Tell the kernel the input is read once from start to end, ignored for pipes
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+bool BatchReader::fill() {
+    // Read the next block once the current one is consumed
+    while (position == length) {
+        if (endOfInput)
+            return false;
+        ssize_t count = read(fd, buffer.data(), buffer.size());
+        if (count < 0 && errno == EINTR)
+            continue;
+        if (count <= 0) {
+            endOfInput = true;
+            return false;
+        }
+        position = 0;
+        length = static_cast<size_t>(count);
+    }
+    return true;
+}
+
+bool BatchReader::skipBlanks() {
+    // Spaces, tabs and line breaks (including Windows ones) separate the tokens
+    while (fill()) {
+        char c = buffer[position];
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            return true;
+        position++;
+    }
+    return false;
+}
+
+bool BatchReader::readInt(long long& value) {
+    // Parse the digits of a non-negative integer
+    if (!skipBlanks())
+        return false;
+    value = 0;
+    int digits = 0;
+    while (fill()) {
+        char c = buffer[position];
+        if (c < '0' || c > '9')
+            break;
+        if (digits++ == 18)
+            return false; // Too large to be a valid count or dimension
+        value = value * 10 + (c - '0');
+        position++;
+    }
+    return digits > 0;
+}
+
+std::string BatchReader::where() const {
+    return "instance " + std::to_string(instanceCount + 1) + " : ";
+}
+
+bool BatchReader::readDimensions(long long& n, long long& m, std::string& error) {
+    // Read the dimensions of the labyrinth
+    if (!readInt(n) || !readInt(m)) {
+        error = where() + "missing or invalid dimensions.";
+        return false;
+    }
+    if (n < 1 || m < 1 || n > MaxDimension || m > MaxDimension) {
+        error = where() + "dimensions must be between 1 and " + std::to_string(MaxDimension) + ".";
+        return false;
+    }
+    return true;
+}
+
+template <typename Store>
+bool BatchReader::readCells(long long n, long long m, Store store, std::string& error) {
+    // Hand every cell straight from the input block to store, count D, F and S on the way
+    long long countD = 0, countF = 0, countS = 0;
+    for (long long j = 0; j < n; j++) {
+        if (!skipBlanks()) {
+            error = where() + "missing row " + std::to_string(j + 1) + ".";
+            return false;
+        }
+        long long copied = 0;
+        while (copied < m && fill()) {
+            // Take as much of the row as the current block holds
+            size_t available = length - position;
+            size_t wanted = static_cast<size_t>(m - copied);
+            size_t count = available < wanted ? available : wanted;
+            const char* source = &buffer[position];
+            long long cell = j * m + copied;
+            for (size_t k = 0; k < count; k++) {
+                char c = source[k];
+                if (c == ' ' || c == '\n' || c == '\r' || c == '\t') {
+                    count = k; // The row is shorter than m, reported below
+                    wanted = 0;
+                    break;
+                }
+                if (!store(cell + static_cast<long long>(k), c)) {
+                    error = where() + "invalid cell '" + std::string(1, c) + "' in row " + std::to_string(j + 1) + ".";
+                    return false;
+                }
+                countD += c == 'D';
+                countF += c == 'F';
+                countS += c == 'S';
+            }
+            position += count;
+            copied += static_cast<long long>(count);
+            if (wanted == 0)
+                break;
+        }
+
+        // The row must be exactly m cells long
+        if (copied != m || (fill() && buffer[position] != ' ' && buffer[position] != '\n'
+                                   && buffer[position] != '\r' && buffer[position] != '\t')) {
+            error = where() + "row " + std::to_string(j + 1) + " must contain exactly " + std::to_string(m) + " cells.";
+            return false;
+        }
+    }
+
+    // Check that there is at least one occurrence of D, F, and S
+    if (countD < 1 || countF < 1 || countS < 1) {
+        error = where() + "each instance must have at least one 'D', one 'F', and one 'S'.";
+        return false;
+    }
+    prisonerCount = countD;
+    exitCount = countS;
+
+    instanceCount++;
+    return true;
+}
+
+bool BatchReader::readRows(WeightedGraph::GridGraph& grid, long long n, long long m, int& start, int& end, std::string& error) {
+    // Vertex numbers of a GridGraph are int
+    if (n * m > std::numeric_limits<int>::max()) {
+        error = where() + "too many cells for a GridGraph.";
+        return false;
+    }
+
+    // Reuse the memory of the previous instance
+    grid.reset(static_cast<int>(n), static_cast<int>(m));
+
+    // Copy the labels, terrain symbols with their costs, and locate the first prisoner and the first exit
+    // Unknown symbols are refused in the same pass, as by the packed grid
+    start = -1;
+    end = -1;
+    return readCells(n, m, [&](long long cell, char c) {
+        if (!grid.setCell(static_cast<int>(cell), c))
+            return false;
+        if (c == 'D' && start == -1)
+            start = static_cast<int>(cell);
+        else if (c == 'S' && end == -1)
+            end = static_cast<int>(cell);
+        return true;
+    }, error);
+}
+
+bool BatchReader::readRows(PackedGrid& grid, long long n, long long m, std::string& error) {
+    // Encode the labels on 4 bits as they are read
+    grid.reset(n, m);
+    if (!readCells(n, m, [&](long long cell, char c) {
+        return grid.setLabel(cell, c);
+    }, error))
+        return false;
+
+    // The packed decision follows a single prisoner
+    if (prisonerCount > 1) {
+        error = "instance " + std::to_string(instanceCount) + " : instances of " + std::to_string(PackedGrid::MinimumCells)
+                + " cells or more must have a single 'D'.";
+        return false;
+    }
+    return true;
+}
+
+bool BatchReader::readInstance(WeightedGraph::GridGraph& grid, int& start, int& end, std::string& error) {
+    long long n = 0, m = 0;
+    return readDimensions(n, m, error) && readRows(grid, n, m, start, end, error);
+}
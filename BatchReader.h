@@ -0,0 +1,80 @@
+#ifndef LABYRINTH_BATCHREADER_H
+#define LABYRINTH_BATCHREADER_H
+
+#include "WeightedGraph.h" // Include the declaration of the WeightedGraph class
+#include "PackedGrid.h" // Include the declaration of the PackedGrid class
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+
+// Non-interactive reader of labyrinth instances in the prompt format:
+// the number of instances, then for each instance "n m" followed by n rows of m cells
+// The input is read in large blocks and the rows are parsed straight into the grid, without line buffers
+class BatchReader {
+public:
+    // Size of the blocks read from the input
+    static const size_t BlockSize = 1 << 22;
+
+    // Largest accepted number of lines or cells per line
+    static const long long MaxDimension = 1000000;
+
+    // Reader of an already open file descriptor, it is not closed by the reader
+    explicit BatchReader(int fd);
+
+    // Read a non-negative integer, return false at the end of the input or on a malformed number
+    bool readInt(long long& value);
+
+    // Read the dimensions "n m" of the next instance
+    bool readDimensions(long long& n, long long& m, std::string& error);
+
+    // Read the n rows of the instance into the grid, reusing its memory, and locate the first prisoner (D) and the first exit (S)
+    // Every instance has at least one 'D', one 'F' and one 'S', and any number of each
+    // Return false and describe the problem in error when the rows are malformed or the input ends
+    bool readRows(WeightedGraph::GridGraph& grid, long long n, long long m, int& start, int& end, std::string& error);
+
+    // Read the n rows of the instance into a packed grid, 4 bits per cell, only '.', '#', 'D', 'F' and 'S' are accepted
+    // and the instance must have a single prisoner
+    bool readRows(PackedGrid& grid, long long n, long long m, std::string& error);
+
+    // Read the dimensions and the rows of the next instance into the grid
+    bool readInstance(WeightedGraph::GridGraph& grid, int& start, int& end, std::string& error);
+
+    // Number of instances read so far
+    long long instancesRead() const {
+        return instanceCount;
+    }
+
+    // Number of prisoners (D) of the last instance read
+    long long prisoners() const {
+        return prisonerCount;
+    }
+
+    // Number of exits (S) of the last instance read
+    long long exits() const {
+        return exitCount;
+    }
+
+private:
+    int fd; // Input file descriptor
+    std::vector<char> buffer; // Current block of the input
+    size_t position = 0; // Next unread byte of the block
+    size_t length = 0; // Number of valid bytes in the block
+    bool endOfInput = false; // The input has no more blocks
+    long long instanceCount = 0; // Number of instances read so far
+    long long prisonerCount = 0; // Number of prisoners of the last instance read
+    long long exitCount = 0; // Number of exits of the last instance read
+
+    // Make sure at least one unread byte is available, return false at the end of the input
+    bool fill();
+
+    // Skip spaces and line breaks, return false at the end of the input
+    bool skipBlanks();
+
+    // Prefix of the error messages of the instance being read
+    std::string where() const;
+
+    // Read n rows of m cells, call store(cell number, label) for each cell and check the D, F and S counts
+    template <typename Store>
+    bool readCells(long long n, long long m, Store store, std::string& error);
+};
+
+#endif //LABYRINTH_BATCHREADER_H
@@ -0,0 +1,136 @@
+#include "FireBitboard.h" // Include the declaration of the FireBitboard class
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LABYRINTH_X86_KERNELS 1
+#include <immintrin.h> // Include the x86 intrinsics for the SSE2 and AVX2 kernels
+#endif
+
+namespace {
+    // Spread the fire over the words [first, last) of one line, out = (fire + its 4 neighbours) & open
+    // Return a non-zero value if some word changed
+    typedef uint64_t (*SpreadKernel)(const uint64_t* above, const uint64_t* line, const uint64_t* below,
+                                     const uint64_t* open, uint64_t* out, int first, int last);
+
+    uint64_t spreadScalar(const uint64_t* above, const uint64_t* line, const uint64_t* below,
+                          const uint64_t* open, uint64_t* out, int first, int last) {
+        uint64_t changed = 0;
+        for (int k = first; k < last; k++) {
+            uint64_t current = line[k];
+            uint64_t fromLeft = (current << 1) | (line[k - 1] >> 63); // Fire coming from the cell on the left
+            uint64_t fromRight = (current >> 1) | (line[k + 1] << 63); // Fire coming from the cell on the right
+            uint64_t next = (current | fromLeft | fromRight | above[k] | below[k]) & open[k];
+            changed |= next ^ current;
+            out[k] = next;
+        }
+        return changed;
+    }
+
+#ifdef LABYRINTH_X86_KERNELS
+    __attribute__((target("sse2")))
+    uint64_t spreadSse2(const uint64_t* above, const uint64_t* line, const uint64_t* below,
+                        const uint64_t* open, uint64_t* out, int first, int last) {
+        __m128i changed = _mm_setzero_si128();
+        int k = first;
+        for (; k + 2 <= last; k += 2) {
+            __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + k));
+            __m128i before = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + k - 1));
+            __m128i after = _mm_loadu_si128(reinterpret_cast<const __m128i*>(line + k + 1));
+            __m128i fromLeft = _mm_or_si128(_mm_slli_epi64(current, 1), _mm_srli_epi64(before, 63));
+            __m128i fromRight = _mm_or_si128(_mm_srli_epi64(current, 1), _mm_slli_epi64(after, 63));
+            __m128i vertical = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(above + k)),
+                                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(below + k)));
+            __m128i next = _mm_or_si128(_mm_or_si128(current, vertical), _mm_or_si128(fromLeft, fromRight));
+            next = _mm_and_si128(next, _mm_loadu_si128(reinterpret_cast<const __m128i*>(open + k)));
+            changed = _mm_or_si128(changed, _mm_xor_si128(next, current));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k), next);
+        }
+        uint64_t lanes[2];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), changed);
+        return lanes[0] | lanes[1] | spreadScalar(above, line, below, open, out, k, last);
+    }
+
+    __attribute__((target("avx2")))
+    uint64_t spreadAvx2(const uint64_t* above, const uint64_t* line, const uint64_t* below,
+                        const uint64_t* open, uint64_t* out, int first, int last) {
+        __m256i changed = _mm256_setzero_si256();
+        int k = first;
+        for (; k + 4 <= last; k += 4) {
+            __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + k));
+            __m256i before = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + k - 1));
+            __m256i after = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(line + k + 1));
+            __m256i fromLeft = _mm256_or_si256(_mm256_slli_epi64(current, 1), _mm256_srli_epi64(before, 63));
+            __m256i fromRight = _mm256_or_si256(_mm256_srli_epi64(current, 1), _mm256_slli_epi64(after, 63));
+            __m256i vertical = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(above + k)),
+                                               _mm256_loadu_si256(reinterpret_cast<const __m256i*>(below + k)));
+            __m256i next = _mm256_or_si256(_mm256_or_si256(current, vertical), _mm256_or_si256(fromLeft, fromRight));
+            next = _mm256_and_si256(next, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(open + k)));
+            changed = _mm256_or_si256(changed, _mm256_xor_si256(next, current));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), next);
+        }
+        uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), changed);
+        return lanes[0] | lanes[1] | lanes[2] | lanes[3] | spreadScalar(above, line, below, open, out, k, last);
+    }
+#endif
+
+    // Pick the widest kernel supported by the running CPU
+    SpreadKernel selectKernel() {
+#ifdef LABYRINTH_X86_KERNELS
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return spreadAvx2;
+        if (__builtin_cpu_supports("sse2"))
+            return spreadSse2;
+#endif
+        return spreadScalar;
+    }
+}
+
+void FireBitboard::reset(int lines, int rows) {
+    // Resize the bitsets, padding words and lines are zero so shifts never need bound checks
+    this->lines = lines;
+    this->rows = rows;
+    stride = (rows + 63) / 64 + 2;
+    size_t words = static_cast<size_t>(lines + 2) * stride;
+    fire.assign(words, 0);
+    previous.assign(words, 0);
+    trail.assign(words, 0);
+    open.assign(words, 0);
+
+    // Every cell is open, the bits past the end of a line stay 0
+    for (int i = 0; i < lines; i++) {
+        uint64_t* line = &open[static_cast<size_t>(i + 1) * stride + 1];
+        for (int j = 0; j < rows; j += 64) {
+            int count = rows - j < 64 ? rows - j : 64;
+            line[j / 64] = count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1;
+        }
+    }
+}
+
+void FireBitboard::load(const std::vector<char>& labels, int lines, int rows) {
+    // Translate the labels into the wall and fire bitsets
+    reset(lines, rows);
+    for (int v = 0; v < lines * rows; v++) {
+        char label = labels[v];
+        if (label == '#')
+            open[wordOf(v)] &= ~(uint64_t(1) << ((v % rows) & 63));
+        else if (label == 'F' || label == 'A')
+            setBit(fire, v);
+    }
+}
+
+bool FireBitboard::spread() {
+    // One turn of propagation, computed line by line into the other buffer
+    static const SpreadKernel kernel = selectKernel();
+    int words = stride - 2;
+    uint64_t changed = 0;
+    for (int i = 1; i <= lines; i++) {
+        size_t offset = static_cast<size_t>(i) * stride;
+        changed |= kernel(&fire[offset - stride], &fire[offset], &fire[offset + stride],
+                          &open[offset], &previous[offset], 1, words + 1);
+    }
+
+    // The output buffer becomes the current fire, the old fire is kept to detect new ignitions
+    fire.swap(previous);
+    return changed != 0;
+}
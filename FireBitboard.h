@@ -0,0 +1,72 @@
+#ifndef LABYRINTH_FIREBITBOARD_H
+#define LABYRINTH_FIREBITBOARD_H
+
+#include <cstddef> // Size type
+#include <cstdint> // Fixed width integers
+#include <vector> // Dynamic array functionality using vectors
+
+// Bit-parallel fire propagation over a grid stored as row bitsets of 64-bit words
+// Every line is padded with a zero word on both sides and the grid with a zero line above and below,
+// so one turn of spread is a branch-free sequence of shifts, ORs and ANDs
+class FireBitboard {
+public:
+    int lines = 0; // Number of lines of the grid
+    int rows = 0; // Number of cells per line
+    int stride = 0; // Number of words per padded line
+
+    // Prepare an empty board of lines * rows cells where every cell is open, memory is kept between boards
+    void reset(int lines, int rows);
+
+    // Load the walls ('#') and the burning cells ('F' and 'A') from row-major labels
+    void load(const std::vector<char>& labels, int lines, int rows);
+
+    // Spread the fire by one turn into the open cells, return true if at least one cell ignited
+    bool spread();
+
+    // Check if a cell, given by its vertex number, is burning
+    bool isBurning(int vertexNum) const {
+        return testBit(fire, vertexNum);
+    }
+
+    // Check if a cell caught fire during the last spread
+    bool ignitedLastTurn(int vertexNum) const {
+        return testBit(fire, vertexNum) && !testBit(previous, vertexNum);
+    }
+
+    // Check if a cell is a wall
+    bool isWall(int vertexNum) const {
+        return !testBit(open, vertexNum);
+    }
+
+    // Mark a cell as visited by the prisoner and check if it was visited before
+    void markTrail(int vertexNum) {
+        setBit(trail, vertexNum);
+    }
+    bool isTrail(int vertexNum) const {
+        return testBit(trail, vertexNum);
+    }
+
+    // Set a cell on fire
+    void ignite(int vertexNum) {
+        setBit(fire, vertexNum);
+    }
+
+private:
+    std::vector<uint64_t> fire; // Burning cells
+    std::vector<uint64_t> previous; // Burning cells before the last spread, also the spread output buffer
+    std::vector<uint64_t> open; // Cells the fire can enter, padding bits are always 0
+    std::vector<uint64_t> trail; // Cells visited by the prisoner
+
+    // Index of the word holding a cell and position of its bit
+    size_t wordOf(int vertexNum) const {
+        return static_cast<size_t>(vertexNum / rows + 1) * stride + 1 + (vertexNum % rows) / 64;
+    }
+    bool testBit(const std::vector<uint64_t>& bits, int vertexNum) const {
+        return (bits[wordOf(vertexNum)] >> ((vertexNum % rows) & 63)) & 1;
+    }
+    void setBit(std::vector<uint64_t>& bits, int vertexNum) {
+        bits[wordOf(vertexNum)] |= uint64_t(1) << ((vertexNum % rows) & 63);
+    }
+};
+
+#endif //LABYRINTH_FIREBITBOARD_H
@@ -0,0 +1,11 @@
+#include "GridSolver.h" // Include the declaration of the GridSolver class
+
+// Storage of the move tables, indexed at run time by the searches
+constexpr int FourConnected::Count;
+constexpr int FourConnected::Straight;
+constexpr int FourConnected::lineSteps[];
+constexpr int FourConnected::columnSteps[];
+constexpr int EightConnected::Count;
+constexpr int EightConnected::Straight;
+constexpr int EightConnected::lineSteps[];
+constexpr int EightConnected::columnSteps[];
@@ -0,0 +1,253 @@
+#ifndef LABYRINTH_GRIDSOLVER_H
+#define LABYRINTH_GRIDSOLVER_H
+
+#include "IndexedHeap.h" // Include the indexed heap used as priority queue
+#include "PathResult.h" // Include the index based path result
+#include "SolverStats.h" // Include the solver statistics
+#include <cstdint> // Fixed width integers
+#include <limits> // Distance of the unreached cells
+#include <vector> // Dynamic array functionality using vectors
+
+// Moves to the 4 neighbours, in the order of GridGraph::forEachNeighbor: next line, right, left, previous line
+struct FourConnected {
+    static constexpr int Count = 4; // Number of moves
+    static constexpr int Straight = 4; // The first Straight moves change one coordinate, the others are diagonal
+    static constexpr int lineSteps[Count] = {1, 0, 0, -1}; // Change of line of each move
+    static constexpr int columnSteps[Count] = {0, 1, -1, 0}; // Change of column of each move
+};
+
+// Moves to the 8 neighbours: the 4 straight moves, then the diagonals, which may not cut a blocked corner
+struct EightConnected {
+    static constexpr int Count = 8; // Number of moves
+    static constexpr int Straight = 4; // The first Straight moves change one coordinate, the others are diagonal
+    static constexpr int lineSteps[Count] = {1, 0, 0, -1, 1, 1, -1, -1}; // Change of line of each move
+    static constexpr int columnSteps[Count] = {0, 1, -1, 0, 1, -1, 1, -1}; // Change of column of each move
+};
+
+// First in, first out queue: with unit costs the cells leave in order of distance, the search is a breadth-first search
+template <typename Distance>
+class FifoQueue {
+public:
+    void reset(int, int) {
+        cells.clear();
+        head = 0;
+    }
+    bool empty() const {
+        return head == cells.size();
+    }
+    size_t size() const {
+        return cells.size() - head;
+    }
+    void push(int cell, Distance) {
+        cells.push_back(cell);
+    }
+    int pop() {
+        return cells[head++];
+    }
+
+private:
+    std::vector<int> cells; // Queued cells, those before head already left
+    size_t head = 0; // Next cell to leave
+};
+
+// Bucket queue of Dial for small integer costs: a ring of largest cost + 1 buckets indexed by distance.
+// A cell whose distance drops is queued again, its older entry is skipped once the cell is closed
+template <typename Distance>
+class BucketQueue {
+public:
+    void reset(int, int largestCost) {
+        buckets.resize(static_cast<size_t>(largestCost) + 1);
+        for (std::vector<int>& bucket : buckets)
+            bucket.clear();
+        current = 0;
+        count = 0;
+    }
+    bool empty() const {
+        return count == 0;
+    }
+    size_t size() const {
+        return count;
+    }
+    void push(int cell, Distance distance) {
+        buckets[static_cast<size_t>(distance % static_cast<Distance>(buckets.size()))].push_back(cell);
+        count++;
+    }
+    int pop() {
+        while (buckets[static_cast<size_t>(current % static_cast<Distance>(buckets.size()))].empty())
+            current++;
+        std::vector<int>& bucket = buckets[static_cast<size_t>(current % static_cast<Distance>(buckets.size()))];
+        int cell = bucket.back();
+        bucket.pop_back();
+        count--;
+        return cell;
+    }
+
+private:
+    std::vector<std::vector<int>> buckets; // Cells by distance modulo the number of buckets
+    Distance current = 0; // Distance of the bucket being emptied
+    size_t count = 0; // Queued entries, stale ones included
+};
+
+// Indexed heap for real costs, a cell is queued once and its key lowered in place
+template <typename Distance>
+class HeapQueue {
+public:
+    void reset(int numberV, int) {
+        heap.reset(numberV);
+    }
+    bool empty() const {
+        return heap.empty();
+    }
+    size_t size() const {
+        return static_cast<size_t>(heap.size());
+    }
+    void push(int cell, Distance distance) {
+        heap.push(cell, distance);
+    }
+    int pop() {
+        return heap.pop();
+    }
+
+private:
+    IndexedHeap<Distance> heap; // Open cells by distance
+};
+
+// Every move costs 1: integer distances and a FIFO queue, no heap and no floating point
+struct UnitCost {
+    typedef int Distance; // Number of moves
+    typedef FifoQueue<Distance> Queue; // Breadth-first order
+
+    Distance operator()(int) const {
+        return 1;
+    }
+    int largest() const {
+        return 1;
+    }
+};
+
+// Entering a cell costs its weight, a small integer from 1 to 255: integer distances and a bucket queue
+struct SmallIntegerCost {
+    typedef long long Distance; // Sum of the weights, 10^7 cells of weight 255 do not fit an int
+    typedef BucketQueue<Distance> Queue; // Dial's buckets
+
+    const uint8_t* weights; // Weight of each cell
+    int maximum; // Largest weight, number of buckets - 1
+
+    Distance operator()(int cell) const {
+        return weights[cell];
+    }
+    int largest() const {
+        return maximum;
+    }
+};
+
+// Entering a cell costs its real weight, positive: floating point distances and an indexed heap
+struct RealCost {
+    typedef double Distance; // Sum of the weights
+    typedef HeapQueue<Distance> Queue; // Comparison heap
+
+    const double* weights; // Weight of each cell
+
+    Distance operator()(int cell) const {
+        return weights[cell];
+    }
+    int largest() const {
+        return 0;
+    }
+};
+
+// Shortest path search on a grid specialised at compile time on its moves and on its cost model
+// The moves come from the constant tables of Neighborhood, the queue from Cost::Queue, so a 4-connected unit-cost
+// search compiles to a breadth-first search. The prisoner enters the '.' and 'S' cells, the start may hold any label.
+// Coordinates are checked on both axes, a move never wraps from the end of a line to the next one
+template <typename Neighborhood, typename Cost>
+class GridSolver {
+public:
+    typedef typename Cost::Distance Distance; // Type of the distances
+
+    // Distance of the cells that were not reached
+    static Distance unreached() {
+        return std::numeric_limits<Distance>::max();
+    }
+
+    // Find a shortest path from start to end and store it in path, empty when the end cannot be reached.
+    // Moves that are not between 4-neighbours end path.moves, the cells stay complete. Memory is kept between searches
+    bool shortestPath(const std::vector<char>& labels, int lines, int rows, int start, int end, const Cost& cost,
+                      PathResult& path, SolverStats* stats = nullptr) {
+        PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+        path.clear();
+        int numberV = lines * rows;
+        distance.assign(numberV, unreached());
+        previous.assign(numberV, -1);
+        closed.assign((static_cast<size_t>(numberV) + 63) / 64, 0);
+        queue.reset(numberV, cost.largest());
+        distance[start] = 0;
+        queue.push(start, 0);
+        long long expanded = 0, relaxed = 0, pushes = 1, pops = 0, peak = 1;
+
+        auto enterable = [&](int cell) {
+            return labels[cell] == '.' || labels[cell] == 'S';
+        };
+        bool found = false;
+        while (!queue.empty()) {
+            int cell = queue.pop();
+            pops++;
+            uint64_t bit = uint64_t(1) << (cell & 63);
+            if (closed[cell >> 6] & bit)
+                continue; // Older entry of a cell whose distance dropped
+            closed[cell >> 6] |= bit;
+            if (cell == end) {
+                found = true;
+                break;
+            }
+            expanded++;
+
+            int i = cell / rows, j = cell % rows;
+            for (int move = 0; move < Neighborhood::Count; move++) {
+                int ni = i + Neighborhood::lineSteps[move], nj = j + Neighborhood::columnSteps[move];
+                if (ni < 0 || ni >= lines || nj < 0 || nj >= rows)
+                    continue;
+                int next = ni * rows + nj;
+                relaxed++;
+                if (!enterable(next))
+                    continue;
+                if (move >= Neighborhood::Straight && (!enterable(i * rows + nj) || !enterable(ni * rows + j)))
+                    continue; // A diagonal move needs both cells of the corner
+                Distance newDistance = distance[cell] + cost(next);
+                if (newDistance < distance[next]) {
+                    distance[next] = newDistance;
+                    previous[next] = cell;
+                    queue.push(next, newDistance);
+                    pushes++;
+                    if (static_cast<long long>(queue.size()) > peak)
+                        peak = static_cast<long long>(queue.size());
+                }
+            }
+        }
+
+        if (stats != nullptr) {
+            stats->verticesExpanded += expanded;
+            stats->edgesRelaxed += relaxed;
+            stats->heapPushes += pushes;
+            stats->heapPops += pops;
+            if (peak > stats->peakOpenSet)
+                stats->peakOpenSet = peak;
+        }
+        if (found)
+            path.rebuild(end, rows, [&](int v) { return previous[v]; });
+        return found;
+    }
+
+    // Distance of a cell after the last search, unreached() when it was not reached before the search stopped
+    Distance distanceTo(int cell) const {
+        return distance[cell];
+    }
+
+private:
+    std::vector<Distance> distance; // Distance from the start of each cell
+    std::vector<int> previous; // Previous cell on the best path, -1 for none
+    std::vector<uint64_t> closed; // Bit set of the cells whose distance is final
+    typename Cost::Queue queue; // Open cells, in the order the cost model needs
+};
+
+#endif //LABYRINTH_GRIDSOLVER_H
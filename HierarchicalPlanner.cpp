@@ -0,0 +1,562 @@
+#include "HierarchicalPlanner.h" // Include the declaration of the HierarchicalPlanner class
+#include <algorithm> // Include the algorithm header for std::sort and std::binary_search
+#include <atomic> // Include the atomic header for the shared work counter
+#include <cstdio> // Include the cstdio header for the saved files
+#include <cstdlib> // Include the cstdlib header for std::abs
+#include <thread> // Include the thread header for the build threads
+#include <unordered_map> // Include the unordered_map header for the loops of the refined paths
+
+const int HierarchicalPlanner::DefaultClusterSize;
+
+namespace {
+    // Runs of at least this many entrance pairs get an entrance at each end instead of one in the middle
+    const int LongEntrance = 6;
+
+    // Distance of the abstract nodes not reached yet
+    const int Unreached = 0x3fffffff;
+
+    // Header of the saved files
+    const uint32_t Magic = 0x4150484c; // "LHPA"
+    const uint32_t Version = 1;
+
+    // Call work(index, thread) for every index below count, the indices being shared by the given number of threads
+    template <typename Work>
+    void forEachIndex(size_t count, int threads, Work work) {
+        std::atomic<size_t> next(0);
+        auto run = [&](int thread) {
+            for (size_t index = next++; index < count; index = next++)
+                work(index, thread);
+        };
+        std::vector<std::thread> helpers;
+        for (int t = 1; t < threads && static_cast<size_t>(t) < count; t++)
+            helpers.emplace_back(run, t);
+        run(0);
+        for (std::thread& helper : helpers)
+            helper.join();
+    }
+
+    // Write a vector as its size followed by its values, an empty vector has no data to pass to fwrite
+    bool writeValues(FILE* out, const std::vector<int>& values) {
+        uint32_t count = static_cast<uint32_t>(values.size());
+        return std::fwrite(&count, sizeof(count), 1, out) == 1 &&
+               (count == 0 || std::fwrite(values.data(), sizeof(int), values.size(), out) == values.size());
+    }
+
+    // Read a vector written by writeValues, at most limit values
+    bool readValues(FILE* in, std::vector<int>& values, size_t limit) {
+        uint32_t count = 0;
+        if (std::fread(&count, sizeof(count), 1, in) != 1 || count > limit)
+            return false;
+        values.resize(count);
+        return count == 0 || std::fread(values.data(), sizeof(int), count, in) == count;
+    }
+}
+
+void HierarchicalPlanner::build(const std::vector<char>& labels, int lines, int rows, int clusterSize, int threads) {
+    // Cut the grid into clusters, then find every entrance and connect every cluster
+    this->lines = lines;
+    this->rows = rows;
+    this->clusterSize = clusterSize < 2 ? 2 : clusterSize;
+    clusterLines = (lines + this->clusterSize - 1) / this->clusterSize;
+    clusterColumns = (rows + this->clusterSize - 1) / this->clusterSize;
+    int numberV = lines * rows;
+    freeCells.assign((static_cast<size_t>(numberV) + 63) / 64, 0);
+    for (int v = 0; v < numberV; v++)
+        setFree(labels, v);
+    print = fingerprint();
+
+    clusters.resize(static_cast<size_t>(clusterLines) * clusterColumns);
+    std::vector<int> all(clusters.size());
+    for (size_t k = 0; k < all.size(); k++)
+        all[k] = static_cast<int>(k);
+    rebuild(all, all, threads);
+}
+
+void HierarchicalPlanner::update(const std::vector<char>& labels, const std::vector<int>& cells, int threads) {
+    // A cell changes the distances of its cluster. On the last line or column of its cluster it also changes the border
+    // with the next cluster, on the first ones the border with the previous cluster, and so the nodes of both
+    std::vector<int> borders, changed;
+    auto border = [&](int owner, int neighbor) {
+        borders.push_back(owner);
+        changed.push_back(owner);
+        changed.push_back(neighbor);
+    };
+    for (int cell : cells) {
+        setFree(labels, cell);
+        int k = clusterOf(cell);
+        changed.push_back(k);
+        int i = cell / rows, j = cell % rows;
+        int i0 = firstLine(k), j0 = firstColumn(k);
+        int i1 = std::min(i0 + clusterSize, lines), j1 = std::min(j0 + clusterSize, rows);
+        if (j == j1 - 1 && j1 < rows)
+            border(k, k + 1);
+        if (j == j0 && j0 > 0)
+            border(k - 1, k);
+        if (i == i1 - 1 && i1 < lines)
+            border(k, k + clusterColumns);
+        if (i == i0 && i0 > 0)
+            border(k - clusterColumns, k);
+    }
+    print = fingerprint();
+    std::sort(borders.begin(), borders.end());
+    borders.erase(std::unique(borders.begin(), borders.end()), borders.end());
+    std::sort(changed.begin(), changed.end());
+    changed.erase(std::unique(changed.begin(), changed.end()), changed.end());
+    rebuild(borders, changed, threads);
+}
+
+void HierarchicalPlanner::rebuild(const std::vector<int>& borders, const std::vector<int>& changed, int threads) {
+    // The borders only read the free cells, the nodes only read the borders, so each phase runs on every thread
+    if (threads < 1)
+        threads = 1;
+    if (static_cast<int>(locals.size()) < threads)
+        locals.resize(threads);
+    forEachIndex(borders.size(), threads, [&](size_t n, int) {
+        scanBorders(borders[n]);
+    });
+    forEachIndex(changed.size(), threads, [&](size_t n, int thread) {
+        connect(changed[n], locals[thread]);
+    });
+    index();
+}
+
+void HierarchicalPlanner::setFree(const std::vector<char>& labels, int cell) {
+    uint64_t bit = uint64_t(1) << (cell & 63);
+    if (labels[cell] == '.' || labels[cell] == 'S')
+        freeCells[static_cast<size_t>(cell) >> 6] |= bit;
+    else
+        freeCells[static_cast<size_t>(cell) >> 6] &= ~bit;
+}
+
+uint64_t HierarchicalPlanner::fingerprint() const {
+    // FNV-1a over the dimensions and the words of the bit set
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    mix(static_cast<uint64_t>(lines));
+    mix(static_cast<uint64_t>(rows));
+    for (uint64_t word : freeCells)
+        mix(word);
+    return hash;
+}
+
+uint64_t HierarchicalPlanner::fingerprint(const std::vector<char>& labels, int lines, int rows) {
+    // The words of the bit set are gathered from the labels 64 cells at a time, the last one padded with zeros
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+    mix(static_cast<uint64_t>(lines));
+    mix(static_cast<uint64_t>(rows));
+    size_t numberV = static_cast<size_t>(lines) * static_cast<size_t>(rows);
+    for (size_t first = 0; first < numberV; first += 64) {
+        uint64_t word = 0;
+        size_t count = std::min<size_t>(64, numberV - first);
+        for (size_t bit = 0; bit < count; bit++) {
+            char label = labels[first + bit];
+            word |= static_cast<uint64_t>(label == '.' || label == 'S') << bit;
+        }
+        mix(word);
+    }
+    return hash;
+}
+
+void HierarchicalPlanner::scanBorders(int k) {
+    // Cells of the cluster paired with the free cell across the border, runs of pairs give one or two entrances
+    Cluster& cluster = clusters[k];
+    cluster.rightBorder.clear();
+    cluster.bottomBorder.clear();
+    int i0 = firstLine(k), j0 = firstColumn(k);
+    int i1 = std::min(i0 + clusterSize, lines), j1 = std::min(j0 + clusterSize, rows);
+    auto scan = [&](std::vector<int>& entrances, int first, int count, int step, int across) {
+        int runStart = -1;
+        for (int n = 0; n <= count; n++) {
+            int cell = first + n * step;
+            bool open = n < count && isFree(cell) && isFree(cell + across);
+            if (open && runStart == -1)
+                runStart = n;
+            if (open || runStart == -1)
+                continue;
+            int length = n - runStart;
+            if (length >= LongEntrance) {
+                entrances.push_back(first + runStart * step);
+                entrances.push_back(first + (n - 1) * step);
+            } else {
+                entrances.push_back(first + (runStart + (length - 1) / 2) * step);
+            }
+            runStart = -1;
+        }
+    };
+    if (j1 < rows)
+        scan(cluster.rightBorder, i0 * rows + j1 - 1, i1 - i0, rows, 1);
+    if (i1 < lines)
+        scan(cluster.bottomBorder, (i1 - 1) * rows + j0, j1 - j0, 1, rows);
+}
+
+void HierarchicalPlanner::connect(int k, LocalSearch& local) {
+    // Nodes from the borders the cluster owns and from those its previous neighbours own
+    Cluster& cluster = clusters[k];
+    cluster.nodes.assign(cluster.rightBorder.begin(), cluster.rightBorder.end());
+    cluster.nodes.insert(cluster.nodes.end(), cluster.bottomBorder.begin(), cluster.bottomBorder.end());
+    if (firstColumn(k) > 0)
+        for (int cell : clusters[k - 1].rightBorder)
+            cluster.nodes.push_back(cell + 1);
+    if (firstLine(k) > 0)
+        for (int cell : clusters[k - clusterColumns].bottomBorder)
+            cluster.nodes.push_back(cell + rows);
+    std::sort(cluster.nodes.begin(), cluster.nodes.end());
+    cluster.nodes.erase(std::unique(cluster.nodes.begin(), cluster.nodes.end()), cluster.nodes.end());
+
+    // Moves are reversible, one search per node fills its line and its column of the distances
+    size_t count = cluster.nodes.size();
+    cluster.distances.assign(count * count, -1);
+    for (size_t a = 0; a < count; a++) {
+        cluster.distances[a * count + a] = 0;
+        if (a + 1 == count)
+            break;
+        if (a == 0)
+            enter(k, local);
+        searchInside(local, cluster.nodes[a], -1, nullptr);
+        for (size_t b = a + 1; b < count; b++) {
+            int moves = local.distance[local.slotOf(cluster.nodes[b], rows)];
+            cluster.distances[a * count + b] = moves;
+            cluster.distances[b * count + a] = moves;
+        }
+    }
+}
+
+void HierarchicalPlanner::index() {
+    firstNode.resize(clusters.size() + 1);
+    firstNode[0] = 0;
+    for (size_t k = 0; k < clusters.size(); k++)
+        firstNode[k + 1] = firstNode[k] + static_cast<int>(clusters[k].nodes.size());
+}
+
+int HierarchicalPlanner::nodeOf(int k, int cell) const {
+    const std::vector<int>& nodes = clusters[k].nodes;
+    return firstNode[k] + static_cast<int>(std::lower_bound(nodes.begin(), nodes.end(), cell) - nodes.begin());
+}
+
+void HierarchicalPlanner::enter(int k, LocalSearch& local) const {
+    int i0 = firstLine(k), j0 = firstColumn(k);
+    int i1 = std::min(i0 + clusterSize, lines), j1 = std::min(j0 + clusterSize, rows);
+    local.firstLine = i0;
+    local.firstColumn = j0;
+    local.width = j1 - j0 + 2;
+    local.open.assign(static_cast<size_t>(local.width) * (i1 - i0 + 2), 0);
+    for (int i = i0; i < i1; i++)
+        for (int j = j0; j < j1; j++)
+            local.open[(i - i0 + 1) * local.width + j - j0 + 1] = isFree(i * rows + j);
+}
+
+void HierarchicalPlanner::searchInside(LocalSearch& local, int source, int target, SolverStats* stats) const {
+    // Breadth-first search through the free cells of the cluster, the source may hold any label
+    int width = local.width;
+    int last = target == -1 ? -1 : local.slotOf(target, rows);
+    local.distance.assign(local.open.size(), -1);
+    local.previous.assign(local.open.size(), -1);
+    int first = local.slotOf(source, rows);
+    local.queue.assign(1, first);
+    local.distance[first] = 0;
+    long long expanded = 0;
+    for (size_t head = 0; head < local.queue.size(); head++) {
+        int slot = local.queue[head];
+        if (slot == last)
+            break;
+        expanded++;
+        int moves = local.distance[slot] + 1;
+        const int neighbors[4] = {slot + width, slot + 1, slot - 1, slot - width};
+        for (int next : neighbors) {
+            if (!local.open[next] || local.distance[next] != -1)
+                continue;
+            local.distance[next] = moves;
+            local.previous[next] = slot;
+            local.queue.push_back(next);
+        }
+    }
+    if (stats != nullptr) {
+        stats->verticesExpanded += expanded;
+        stats->edgesRelaxed += 4 * expanded;
+        stats->heapPushes += static_cast<long long>(local.queue.size());
+        stats->heapPops += expanded;
+    }
+}
+
+bool HierarchicalPlanner::findPath(int start, int end, PathResult& path, SolverStats* stats) {
+    path.clear();
+    if (start == end) {
+        route.assign(1, start);
+        path.assign(route, rows);
+        return true;
+    }
+    if (!isFree(end))
+        return false;
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+    if (locals.empty())
+        locals.resize(1);
+    LocalSearch& local = locals[0];
+
+    // The start may hold any label, so it is never an entrance: it is linked to the nodes of its cluster, to those
+    // of the clusters its first move can enter, and to the end when it lies in one of them
+    int nodes = nodeCount();
+    int startNode = nodes, endNode = nodes + 1;
+    int startCluster = clusterOf(start), endCluster = clusterOf(end);
+    int startLine = start / rows, startColumn = start % rows;
+    auto neighborIn = [&](int k) {
+        const int neighbors[4] = {startLine + 1 < lines ? start + rows : -1, startColumn + 1 < rows ? start + 1 : -1,
+                                  startColumn > 0 ? start - 1 : -1, startLine > 0 ? start - rows : -1};
+        for (int neighbor : neighbors)
+            if (neighbor != -1 && clusterOf(neighbor) == k && isFree(neighbor))
+                return neighbor;
+        return -1;
+    };
+    startLinks.clear();
+    const int sources[5] = {start, startLine + 1 < lines ? start + rows : -1, startColumn + 1 < rows ? start + 1 : -1,
+                            startColumn > 0 ? start - 1 : -1, startLine > 0 ? start - rows : -1};
+    for (int source : sources) {
+        int k = source == -1 ? -1 : clusterOf(source);
+        if (source != start && (k == -1 || k == startCluster || !isFree(source)))
+            continue;
+        int moves = source == start ? 0 : 1;
+        enter(k, local);
+        searchInside(local, source, -1, stats);
+        const Cluster& cluster = clusters[k];
+        for (size_t a = 0; a < cluster.nodes.size(); a++) {
+            int distance = local.distance[local.slotOf(cluster.nodes[a], rows)];
+            if (distance >= 0) {
+                startLinks.push_back(firstNode[k] + static_cast<int>(a));
+                startLinks.push_back(moves + distance);
+            }
+        }
+        if (k == endCluster && local.distance[local.slotOf(end, rows)] >= 0) {
+            startLinks.push_back(endNode);
+            startLinks.push_back(moves + local.distance[local.slotOf(end, rows)]);
+        }
+    }
+
+    // The end is free, its distances to the nodes of its cluster are those from it
+    const Cluster& last = clusters[endCluster];
+    enter(endCluster, local);
+    searchInside(local, end, -1, stats);
+    endDistances.resize(last.nodes.size());
+    for (size_t a = 0; a < last.nodes.size(); a++)
+        endDistances[a] = local.distance[local.slotOf(last.nodes[a], rows)];
+
+    // A* over the abstract nodes, the start and the end numbered after them
+    cost.assign(nodes + 2, Unreached);
+    previous.assign(nodes + 2, -1);
+    queue.reset(nodes + 2);
+    int endLine = end / rows, endColumn = end % rows;
+    long long expanded = 0, relaxed = 0, pushes = 1, pops = 0, peak = 1;
+    auto relax = [&](int from, int to, int toCell, int moves) {
+        relaxed++;
+        int newCost = cost[from] + moves;
+        if (newCost >= cost[to])
+            return;
+        cost[to] = newCost;
+        previous[to] = from;
+        int heuristic = std::abs(toCell / rows - endLine) + std::abs(toCell % rows - endColumn);
+        queue.push(to, Key{newCost + heuristic, newCost});
+        pushes++;
+        if (queue.size() > peak)
+            peak = queue.size();
+    };
+    cost[startNode] = 0;
+    queue.push(startNode, Key{std::abs(start / rows - endLine) + std::abs(start % rows - endColumn), 0});
+
+    bool found = false;
+    while (!queue.empty()) {
+        int node = queue.pop();
+        pops++;
+        if (node == endNode) {
+            found = true;
+            break;
+        }
+        expanded++;
+        if (node == startNode) {
+            for (size_t link = 0; link < startLinks.size(); link += 2) {
+                int to = startLinks[link];
+                int k = to == endNode ? -1 : static_cast<int>(std::upper_bound(firstNode.begin(), firstNode.end(), to) - firstNode.begin()) - 1;
+                relax(node, to, k == -1 ? end : clusters[k].nodes[to - firstNode[k]], startLinks[link + 1]);
+            }
+            continue;
+        }
+
+        // Moves inside the cluster, to the end when it lies there, then across the borders at the entrances
+        int k = static_cast<int>(std::upper_bound(firstNode.begin(), firstNode.end(), node) - firstNode.begin()) - 1;
+        const Cluster& cluster = clusters[k];
+        size_t count = cluster.nodes.size(), a = static_cast<size_t>(node - firstNode[k]);
+        int cell = cluster.nodes[a];
+        for (size_t b = 0; b < count; b++)
+            if (b != a && cluster.distances[a * count + b] >= 0)
+                relax(node, firstNode[k] + static_cast<int>(b), cluster.nodes[b], cluster.distances[a * count + b]);
+        if (k == endCluster && endDistances[a] >= 0)
+            relax(node, endNode, end, endDistances[a]);
+
+        int i = cell / rows, j = cell % rows;
+        int i0 = firstLine(k), j0 = firstColumn(k);
+        int i1 = std::min(i0 + clusterSize, lines), j1 = std::min(j0 + clusterSize, rows);
+        auto entrance = [](const std::vector<int>& border, int side) {
+            return std::binary_search(border.begin(), border.end(), side);
+        };
+        if (j == j1 - 1 && j1 < rows && entrance(cluster.rightBorder, cell))
+            relax(node, nodeOf(k + 1, cell + 1), cell + 1, 1);
+        if (j == j0 && j0 > 0 && entrance(clusters[k - 1].rightBorder, cell - 1))
+            relax(node, nodeOf(k - 1, cell - 1), cell - 1, 1);
+        if (i == i1 - 1 && i1 < lines && entrance(cluster.bottomBorder, cell))
+            relax(node, nodeOf(k + clusterColumns, cell + rows), cell + rows, 1);
+        if (i == i0 && i0 > 0 && entrance(clusters[k - clusterColumns].bottomBorder, cell - rows))
+            relax(node, nodeOf(k - clusterColumns, cell - rows), cell - rows, 1);
+    }
+
+    if (stats != nullptr) {
+        stats->verticesExpanded += expanded;
+        stats->edgesRelaxed += relaxed;
+        stats->heapPushes += pushes;
+        stats->heapPops += pops;
+        if (peak > stats->peakOpenSet)
+            stats->peakOpenSet = peak;
+    }
+    if (!found)
+        return false;
+
+    // Cells of the abstract nodes from the start to the end
+    std::vector<int> waypoints;
+    for (int node = endNode; node != -1; node = previous[node]) {
+        if (node == startNode || node == endNode) {
+            waypoints.push_back(node == startNode ? start : end);
+        } else {
+            int k = static_cast<int>(std::upper_bound(firstNode.begin(), firstNode.end(), node) - firstNode.begin()) - 1;
+            waypoints.push_back(clusters[k].nodes[node - firstNode[k]]);
+        }
+    }
+    std::reverse(waypoints.begin(), waypoints.end());
+
+    // Refine each abstract edge: a move across a border as is, a move inside a cluster by a search in that cluster.
+    // The first edge may begin with the move of the start into the next cluster
+    route.assign(1, start);
+    for (size_t w = 0; w + 1 < waypoints.size(); w++) {
+        int from = waypoints[w], to = waypoints[w + 1];
+        int k = clusterOf(to);
+        if (clusterOf(from) != k) {
+            from = w == 0 ? neighborIn(k) : to;
+            route.push_back(from);
+        }
+        if (from == to)
+            continue;
+        enter(k, local);
+        searchInside(local, from, to, stats);
+        size_t segment = route.size();
+        int source = local.slotOf(from, rows);
+        for (int slot = local.slotOf(to, rows); slot != source; slot = local.previous[slot])
+            route.push_back(local.cellOf(slot, rows));
+        std::reverse(route.begin() + static_cast<std::ptrdiff_t>(segment), route.end());
+    }
+
+    // Consecutive segments may come back through a cell, cut those loops
+    std::unordered_map<int, size_t> seen;
+    size_t length = 0;
+    for (size_t n = 0; n < route.size(); n++) {
+        int cell = route[n];
+        auto earlier = seen.find(cell);
+        if (earlier == seen.end()) {
+            seen[cell] = length;
+            route[length++] = cell;
+            continue;
+        }
+        for (size_t cut = earlier->second + 1; cut < length; cut++)
+            seen.erase(route[cut]);
+        length = earlier->second + 1;
+    }
+    route.resize(length);
+    path.assign(route, rows);
+    return true;
+}
+
+bool HierarchicalPlanner::save(const std::string& file, std::string& error) const {
+    // Header, dimensions and fingerprint of the free cells, then the borders, nodes and distances of every cluster
+    FILE* out = std::fopen(file.c_str(), "wb");
+    if (out == nullptr) {
+        error = "cannot write " + file + ".";
+        return false;
+    }
+    uint32_t header[2] = {Magic, Version};
+    int32_t dimensions[3] = {lines, rows, clusterSize};
+    uint64_t print = fingerprint();
+    bool written = std::fwrite(header, sizeof(header), 1, out) == 1 &&
+                   std::fwrite(dimensions, sizeof(dimensions), 1, out) == 1 &&
+                   std::fwrite(&print, sizeof(print), 1, out) == 1;
+    for (size_t k = 0; k < clusters.size() && written; k++) {
+        const Cluster& cluster = clusters[k];
+        written = writeValues(out, cluster.rightBorder) && writeValues(out, cluster.bottomBorder) &&
+                  writeValues(out, cluster.nodes) && writeValues(out, cluster.distances);
+    }
+    if (std::fclose(out) != 0 || !written) {
+        error = "cannot write " + file + ".";
+        return false;
+    }
+    return true;
+}
+
+bool HierarchicalPlanner::load(const std::string& file, const std::vector<char>& labels, int lines, int rows,
+                               std::string& error) {
+    FILE* in = std::fopen(file.c_str(), "rb");
+    if (in == nullptr) {
+        error = "cannot read " + file + ".";
+        return false;
+    }
+    uint32_t header[2] = {0, 0};
+    int32_t dimensions[3] = {0, 0, 0};
+    uint64_t print = 0;
+    bool valid = std::fread(header, sizeof(header), 1, in) == 1 && header[0] == Magic && header[1] == Version &&
+                 std::fread(dimensions, sizeof(dimensions), 1, in) == 1 && std::fread(&print, sizeof(print), 1, in) == 1;
+    if (!valid) {
+        std::fclose(in);
+        error = file + " is not a saved abstraction.";
+        return false;
+    }
+
+    // The abstraction only fits the free cells it was built from
+    this->lines = lines;
+    this->rows = rows;
+    int numberV = lines * rows;
+    freeCells.assign((static_cast<size_t>(numberV) + 63) / 64, 0);
+    for (int v = 0; v < numberV; v++)
+        setFree(labels, v);
+    if (dimensions[0] != lines || dimensions[1] != rows || dimensions[2] < 2 || print != fingerprint()) {
+        std::fclose(in);
+        clusters.clear();
+        error = file + " was saved for another maze.";
+        return false;
+    }
+    this->print = print;
+    clusterSize = dimensions[2];
+    clusterLines = (lines + clusterSize - 1) / clusterSize;
+    clusterColumns = (rows + clusterSize - 1) / clusterSize;
+    clusters.resize(static_cast<size_t>(clusterLines) * clusterColumns);
+    size_t maximumNodes = 4 * static_cast<size_t>(clusterSize);
+    for (size_t k = 0; k < clusters.size() && valid; k++) {
+        Cluster& cluster = clusters[k];
+        valid = readValues(in, cluster.rightBorder, clusterSize) && readValues(in, cluster.bottomBorder, clusterSize) &&
+                readValues(in, cluster.nodes, maximumNodes) &&
+                readValues(in, cluster.distances, maximumNodes * maximumNodes) &&
+                cluster.distances.size() == cluster.nodes.size() * cluster.nodes.size();
+        for (int cell : cluster.nodes)
+            valid = valid && cell >= 0 && cell < numberV && clusterOf(cell) == static_cast<int>(k);
+        for (int cell : cluster.rightBorder)
+            valid = valid && std::binary_search(cluster.nodes.begin(), cluster.nodes.end(), cell) && cell + 1 < numberV;
+        for (int cell : cluster.bottomBorder)
+            valid = valid && std::binary_search(cluster.nodes.begin(), cluster.nodes.end(), cell) && cell + rows < numberV;
+    }
+    std::fclose(in);
+    if (!valid) {
+        clusters.clear();
+        error = file + " is truncated or corrupted.";
+        return false;
+    }
+    index();
+    return true;
+}
@@ -0,0 +1,164 @@
+#ifndef LABYRINTH_HIERARCHICALPLANNER_H
+#define LABYRINTH_HIERARCHICALPLANNER_H
+
+#include "IndexedHeap.h" // Include the indexed heap used as priority queue
+#include "PathResult.h" // Include the index based path result
+#include "SolverStats.h" // Include the solver statistics
+#include <cstdint> // Fixed width integers
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+
+// Hierarchical path planner (HPA*) on a 4-connected grid with unit costs
+// The grid is cut into square clusters. Where two clusters touch, every run of free cell pairs across their border
+// gives one entrance, or two at its ends when the run is long. The entrance cells are the nodes of an abstract graph,
+// joined by their distances inside their cluster and by single moves across the borders.
+// A search links the start and the end to the nodes of their clusters, runs A* on the abstract graph, then refines
+// each abstract edge inside its cluster. Paths only cross borders at entrances, so they are near-optimal, not optimal.
+// The abstraction is built on several threads, can be saved and loaded, and is repaired cluster by cluster
+// when cells change (walls, burned cells) instead of being rebuilt.
+class HierarchicalPlanner {
+public:
+    // Side of the clusters used when none is given
+    static const int DefaultClusterSize = 16;
+
+    // Build the abstraction of the '.' and 'S' cells of the labels on the given number of threads, memory is kept between builds
+    void build(const std::vector<char>& labels, int lines, int rows, int clusterSize = DefaultClusterSize, int threads = 1);
+
+    // Repair the abstraction after the labels of the given cells changed: only the borders through these cells
+    // and the clusters around them are recomputed
+    void update(const std::vector<char>& labels, const std::vector<int>& cells, int threads = 1);
+
+    // Check if the abstraction was built, loaded or updated for these labels: same dimensions and same fingerprint
+    // of the free cells, the one save and load check. Costs one pass over the labels when the dimensions match
+    bool builtFor(const std::vector<char>& labels, int lines, int rows) const {
+        return !clusters.empty() && this->lines == lines && this->rows == rows && print == fingerprint(labels, lines, rows);
+    }
+
+    // Number of clusters and of abstract nodes
+    int clusterCount() const {
+        return static_cast<int>(clusters.size());
+    }
+    int nodeCount() const {
+        return firstNode.empty() ? 0 : firstNode.back();
+    }
+
+    // Find a path from start, whatever its label, to a free end, return false and an empty path when there is none
+    // stats, when given, receives the counters of the abstract search and of the refinements
+    bool findPath(int start, int end, PathResult& path, SolverStats* stats = nullptr);
+
+    // Write the abstraction to a binary file, return false with a message on failure
+    bool save(const std::string& file, std::string& error) const;
+
+    // Read an abstraction saved for these labels, return false with a message when the file cannot be read
+    // or was saved for another grid
+    bool load(const std::string& file, const std::vector<char>& labels, int lines, int rows, std::string& error);
+
+private:
+    // Entrances and internal distances of one cluster
+    struct Cluster {
+        std::vector<int> rightBorder; // Entrance cells on the border with the next cluster of the line, sorted
+        std::vector<int> bottomBorder; // Entrance cells on the border with the cluster on the next lines, sorted
+        std::vector<int> nodes; // Entrance cells on any of the four borders, sorted
+        std::vector<int> distances; // Moves inside the cluster between every two nodes, row-major, -1 when not connected
+    };
+
+    // Breadth-first search state restricted to one cluster, one per thread
+    // The cluster is copied with a closed frame around it, so its slots have their 4 neighbours at fixed offsets
+    struct LocalSearch {
+        int firstLine = 0; // First line of the copied cluster
+        int firstColumn = 0; // First column of the copied cluster
+        int width = 0; // Slots per line of the copy, the cluster's cells and the frame
+        std::vector<char> open; // 1 for the free cells of the cluster, 0 for the others and the frame
+        std::vector<int> distance; // Moves from the source of each slot, -1 when not reached
+        std::vector<int> previous; // Previous slot in the search, -1 for none
+        std::vector<int> queue; // Flat FIFO queue of slots
+
+        // Slot of a cell of the cluster on a grid of rows cells per line, and back
+        int slotOf(int cell, int rows) const {
+            return (cell / rows - firstLine + 1) * width + cell % rows - firstColumn + 1;
+        }
+        int cellOf(int slot, int rows) const {
+            return (slot / width - 1 + firstLine) * rows + slot % width - 1 + firstColumn;
+        }
+    };
+
+    // Priority of an abstract node: lowest estimate first, deepest node first among equal estimates
+    struct Key {
+        int estimate; // Distance from the start + Manhattan distance to the end
+        int distance; // Distance from the start
+
+        bool operator<(const Key& other) const {
+            if (estimate != other.estimate)
+                return estimate < other.estimate;
+            return distance > other.distance;
+        }
+    };
+
+    int lines = 0; // Number of lines of the grid
+    int rows = 0; // Number of cells per line
+    int clusterSize = DefaultClusterSize; // Side of the clusters
+    int clusterLines = 0; // Number of lines of clusters
+    int clusterColumns = 0; // Number of clusters per line of clusters
+    std::vector<uint64_t> freeCells; // Bit set of the cells the prisoner can enter ('.' and 'S')
+    uint64_t print = 0; // Fingerprint of freeCells, kept up to date by build, update and load
+    std::vector<Cluster> clusters; // Clusters in row-major order
+    std::vector<int> firstNode; // Abstract number of the first node of each cluster, the node count last
+
+    std::vector<LocalSearch> locals; // Cluster searches of the threads
+    std::vector<int> cost; // Distance from the start of each abstract node, the start and the end last
+    std::vector<int> previous; // Previous abstract node on the best path, -1 for none
+    IndexedHeap<Key> queue; // Open abstract nodes
+    std::vector<int> startLinks; // Abstract nodes reached from the start and their distances, in pairs
+    std::vector<int> endDistances; // Distance from each node of the end's cluster to the end, -1 when not connected
+    std::vector<int> route; // Cells of the refined path
+
+    // Check if the prisoner can enter a cell
+    bool isFree(int cell) const {
+        return (freeCells[static_cast<size_t>(cell) >> 6] >> (cell & 63)) & 1;
+    }
+
+    // Cluster holding a cell
+    int clusterOf(int cell) const {
+        return (cell / rows / clusterSize) * clusterColumns + (cell % rows) / clusterSize;
+    }
+
+    // First line and first column of a cluster, the cluster ends clusterSize cells further or at the grid's edge
+    int firstLine(int cluster) const {
+        return cluster / clusterColumns * clusterSize;
+    }
+    int firstColumn(int cluster) const {
+        return cluster % clusterColumns * clusterSize;
+    }
+
+    // Copy the state of a cell from the labels into the bit set of the free cells
+    void setFree(const std::vector<char>& labels, int cell);
+
+    // Fingerprint of the free cells, written with the saved abstraction
+    uint64_t fingerprint() const;
+
+    // Same fingerprint computed from labels, without building the bit set
+    static uint64_t fingerprint(const std::vector<char>& labels, int lines, int rows);
+
+    // Find the entrances on the right and bottom borders of a cluster
+    void scanBorders(int cluster);
+
+    // Gather the nodes of a cluster from its four borders and fill their distances
+    void connect(int cluster, LocalSearch& local);
+
+    // Number the nodes of every cluster
+    void index();
+
+    // Copy a cluster into a local search
+    void enter(int cluster, LocalSearch& local) const;
+
+    // Breadth-first search inside the copied cluster from a cell, stopped once target is reached when target is not -1
+    void searchInside(LocalSearch& local, int source, int target, SolverStats* stats) const;
+
+    // Abstract number of a node given its cluster and its cell
+    int nodeOf(int cluster, int cell) const;
+
+    // Recompute the borders of the clusters in borders, then the nodes of the clusters in changed, on threads
+    void rebuild(const std::vector<int>& borders, const std::vector<int>& changed, int threads);
+};
+
+#endif //LABYRINTH_HIERARCHICALPLANNER_H
@@ -0,0 +1,155 @@
+#include "IncrementalPlanner.h" // Include the declaration of the IncrementalPlanner class
+#include <cstdlib> // Include the cstdlib header for std::abs
+
+const int IncrementalPlanner::Unreachable;
+
+namespace {
+    // Distance one move further, unreachable distances stay unreachable
+    int oneMoreThan(int distance) {
+        return distance >= IncrementalPlanner::Unreachable ? IncrementalPlanner::Unreachable : distance + 1;
+    }
+}
+
+void IncrementalPlanner::reset(const std::vector<char>& labels, int lines, int rows, int start, int goal,
+                               SolverStats* stats) {
+    // Every vertex unknown but the goal, which is queued with distance 0
+    this->lines = lines;
+    this->rows = rows;
+    this->start = start;
+    this->goal = goal;
+    this->stats = stats;
+    km = 0;
+    int numberV = lines * rows;
+    open.resize(numberV);
+    for (int v = 0; v < numberV; v++)
+        open[v] = labels[v] == '.' || labels[v] == 'S' || v == start;
+    g.assign(numberV, Unreachable);
+    rhs.assign(numberV, Unreachable);
+    queue.reset(numberV);
+    rhs[goal] = 0;
+    queue.push(goal, keyOf(goal));
+    if (stats != nullptr)
+        stats->heapPushes++;
+}
+
+int IncrementalPlanner::heuristic(int cell) const {
+    return std::abs(cell / rows - start / rows) + std::abs(cell % rows - start % rows);
+}
+
+IncrementalPlanner::Key IncrementalPlanner::keyOf(int cell) const {
+    long long distance = g[cell] < rhs[cell] ? g[cell] : rhs[cell];
+    return Key{distance + heuristic(cell) + km, distance};
+}
+
+int IncrementalPlanner::lookahead(int cell) const {
+    if (!open[cell])
+        return Unreachable;
+    int best = Unreachable;
+    forEachNeighbor(cell, [&](int neighbor) {
+        if (open[neighbor] && oneMoreThan(g[neighbor]) < best)
+            best = oneMoreThan(g[neighbor]);
+    });
+    return best;
+}
+
+void IncrementalPlanner::updateVertex(int cell) {
+    if (g[cell] != rhs[cell]) {
+        queue.update(cell, keyOf(cell));
+        if (stats != nullptr) {
+            stats->heapPushes++;
+            if (queue.size() > stats->peakOpenSet)
+                stats->peakOpenSet = queue.size();
+        }
+    } else {
+        queue.remove(cell);
+    }
+}
+
+void IncrementalPlanner::close(int cell) {
+    if (!open[cell])
+        return;
+    open[cell] = 0;
+
+    // The cell loses its moves, its neighbours lose the move into it
+    if (cell != goal) {
+        rhs[cell] = Unreachable;
+        updateVertex(cell);
+    }
+    int through = oneMoreThan(g[cell]);
+    forEachNeighbor(cell, [&](int neighbor) {
+        if (neighbor != goal && open[neighbor] && rhs[neighbor] == through) {
+            rhs[neighbor] = lookahead(neighbor);
+            updateVertex(neighbor);
+        }
+    });
+}
+
+void IncrementalPlanner::moveStart(int cell) {
+    // The keys queued for the previous start stay valid lower bounds once km grows by the heuristic drop
+    km += heuristic(cell);
+    start = cell;
+}
+
+void IncrementalPlanner::computeShortestPath() {
+    while (!queue.empty() && (queue.topKey() < keyOf(start) || rhs[start] > g[start])) {
+        int u = queue.top();
+        Key oldKey = queue.topKey();
+        Key newKey = keyOf(u);
+        if (stats != nullptr)
+            stats->heapPops++;
+
+        if (oldKey < newKey) {
+            // Key computed for an earlier start, queue it again with the current one
+            queue.update(u, newKey);
+            continue;
+        }
+
+        if (stats != nullptr)
+            stats->verticesExpanded++;
+        if (g[u] > rhs[u]) {
+            // Overconsistent: the distance dropped, settle it and offer it to the neighbours
+            g[u] = rhs[u];
+            queue.remove(u);
+            int through = oneMoreThan(g[u]);
+            forEachNeighbor(u, [&](int neighbor) {
+                if (stats != nullptr)
+                    stats->edgesRelaxed++;
+                if (neighbor != goal && open[neighbor] && open[u] && through < rhs[neighbor]) {
+                    rhs[neighbor] = through;
+                    updateVertex(neighbor);
+                }
+            });
+        } else {
+            // Underconsistent: the distance rose, every vertex that relied on it looks again
+            int through = oneMoreThan(g[u]);
+            g[u] = Unreachable;
+            if (u != goal)
+                rhs[u] = lookahead(u);
+            updateVertex(u);
+            forEachNeighbor(u, [&](int neighbor) {
+                if (stats != nullptr)
+                    stats->edgesRelaxed++;
+                if (neighbor != goal && rhs[neighbor] == through && through < Unreachable) {
+                    rhs[neighbor] = lookahead(neighbor);
+                    updateVertex(neighbor);
+                }
+            });
+        }
+    }
+}
+
+int IncrementalPlanner::nextMove() {
+    computeShortestPath();
+    if (rhs[start] >= Unreachable)
+        return -1;
+
+    // Follow the neighbour with the smallest distance to the goal
+    int best = -1, bestDistance = Unreachable;
+    forEachNeighbor(start, [&](int neighbor) {
+        if (open[neighbor] && g[neighbor] < bestDistance) {
+            best = neighbor;
+            bestDistance = g[neighbor];
+        }
+    });
+    return best;
+}
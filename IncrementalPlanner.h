@@ -0,0 +1,87 @@
+#ifndef LABYRINTH_INCREMENTALPLANNER_H
+#define LABYRINTH_INCREMENTALPLANNER_H
+
+#include "IndexedHeap.h" // Include the indexed heap used as priority queue
+#include "SolverStats.h" // Include the solver statistics
+#include <vector> // Dynamic array functionality using vectors
+
+// D* Lite planner on a 4-connected grid with unit costs, searching from the goal toward a moving start
+// The search state is kept between moves: when cells close (fire, trail of the prisoner) only the vertices
+// whose distance to the goal went through them are repaired, so a turn costs about the size of the changed region
+class IncrementalPlanner {
+public:
+    // Distance of the cells that cannot reach the goal
+    static const int Unreachable = 1 << 30;
+
+    // Plan from start to goal over the '.' and 'S' cells of the labels and the start itself, memory is kept between plans
+    // stats, when given, receives the counters of every repair
+    void reset(const std::vector<char>& labels, int lines, int rows, int start, int goal, SolverStats* stats = nullptr);
+
+    // Close a cell: it can no longer be entered nor left
+    void close(int cell);
+
+    // Move the start to a neighbouring cell
+    void moveStart(int cell);
+
+    // Repair the plan and return the next cell toward the goal, -1 when the goal cannot be reached
+    int nextMove();
+
+    // Number of moves from the start to the goal after the last repair, Unreachable when there is no path
+    int distance() const {
+        return rhs[start];
+    }
+
+private:
+    // Priority of a vertex: estimate of the path through it first, distance to the goal among equal estimates
+    struct Key {
+        long long estimate; // min(g, rhs) + heuristic from the start + km
+        long long distance; // min(g, rhs)
+
+        bool operator<(const Key& other) const {
+            if (estimate != other.estimate)
+                return estimate < other.estimate;
+            return distance < other.distance;
+        }
+    };
+
+    int lines = 0; // Number of lines of the grid
+    int rows = 0; // Number of cells per line
+    int start = 0; // Current cell of the prisoner
+    int goal = 0; // Exit
+    long long km = 0; // Sum of the heuristic drops caused by the moves of the start
+    std::vector<char> open; // 1 for the cells that can be entered
+    std::vector<int> g; // Distance to the goal of the last expansion of each vertex
+    std::vector<int> rhs; // One-step lookahead distance to the goal of each vertex
+    IndexedHeap<Key> queue; // Inconsistent vertices, g != rhs
+    SolverStats* stats = nullptr; // Counters of the repairs, null to collect none
+
+    // Manhattan distance from the start, admissible and consistent with unit moves
+    int heuristic(int cell) const;
+
+    // Priority of a vertex for the current start
+    Key keyOf(int cell) const;
+
+    // Best distance to the goal through one of the neighbours, Unreachable for a closed cell
+    int lookahead(int cell) const;
+
+    // Queue the vertex when it is inconsistent, drop it from the queue otherwise
+    void updateVertex(int cell);
+
+    // Expand the inconsistent vertices until the start is consistent and no queued key is smaller than its own
+    void computeShortestPath();
+
+    // Call visit(neighbor) for the neighbours of a cell inside the grid
+    template <typename Visit>
+    void forEachNeighbor(int cell, Visit visit) const {
+        if (cell + rows < lines * rows)
+            visit(cell + rows);
+        if ((cell + 1) % rows != 0)
+            visit(cell + 1);
+        if (cell % rows != 0)
+            visit(cell - 1);
+        if (cell >= rows)
+            visit(cell - rows);
+    }
+};
+
+#endif //LABYRINTH_INCREMENTALPLANNER_H
@@ -0,0 +1,166 @@
+#ifndef LABYRINTH_INDEXEDHEAP_H
+#define LABYRINTH_INDEXEDHEAP_H
+
+#include <vector> // Dynamic array functionality using vectors
+
+// Indexed d-ary min-heap over vertex numbers with decrease-key, update and removal support
+// Items are integers in [0, capacity), each item is present at most once
+template <typename Key>
+class IndexedHeap {
+public:
+    // Heap constructor, items must be smaller than capacity
+    explicit IndexedHeap(int capacity = 0) {
+        reset(capacity);
+    }
+
+    // Empty the heap and make room for items in [0, capacity) without releasing memory
+    void reset(int capacity) {
+        for (const Node& node : nodes)
+            if (node.item < static_cast<int>(position.size()))
+                position[node.item] = -1;
+        nodes.clear();
+        if (static_cast<int>(position.size()) < capacity)
+            position.resize(capacity, -1);
+    }
+
+    // Check if the heap is empty
+    bool empty() const {
+        return nodes.empty();
+    }
+
+    // Number of items currently in the heap
+    int size() const {
+        return static_cast<int>(nodes.size());
+    }
+
+    // Check if an item is currently in the heap
+    bool contains(int item) const {
+        return position[item] >= 0;
+    }
+
+    // Insert an item, or lower its key if it is already present with a larger one
+    // Return true if the heap changed
+    bool push(int item, Key key) {
+        int slot = position[item];
+        if (slot < 0) {
+            nodes.push_back(Node{key, item});
+            position[item] = static_cast<int>(nodes.size()) - 1;
+            siftUp(static_cast<int>(nodes.size()) - 1);
+            return true;
+        }
+        if (key < nodes[slot].key) {
+            nodes[slot].key = key;
+            siftUp(slot);
+            return true;
+        }
+        return false;
+    }
+
+    // Set the key of an item, larger or smaller than its current one, inserting it when absent
+    void update(int item, Key key) {
+        int slot = position[item];
+        if (slot < 0) {
+            push(item, key);
+            return;
+        }
+        bool lower = key < nodes[slot].key;
+        nodes[slot].key = key;
+        if (lower)
+            siftUp(slot);
+        else
+            siftDown(slot);
+    }
+
+    // Remove an item if it is in the heap
+    void remove(int item) {
+        int slot = position[item];
+        if (slot < 0)
+            return;
+        position[item] = -1;
+        Node last = nodes.back();
+        nodes.pop_back();
+        if (slot < static_cast<int>(nodes.size())) {
+            nodes[slot] = last;
+            position[last.item] = slot;
+            siftUp(slot);
+            siftDown(position[last.item]);
+        }
+    }
+
+    // Key of the minimal item, the heap must not be empty
+    Key topKey() const {
+        return nodes[0].key;
+    }
+
+    // Minimal item, the heap must not be empty
+    int top() const {
+        return nodes[0].item;
+    }
+
+    // Remove and return the minimal item, the heap must not be empty
+    int pop() {
+        int item = nodes[0].item;
+        position[item] = -1;
+        Node last = nodes.back();
+        nodes.pop_back();
+        if (!nodes.empty()) {
+            nodes[0] = last;
+            position[last.item] = 0;
+            siftDown(0);
+        }
+        return item;
+    }
+
+private:
+    // Number of children per heap node, 4 keeps siblings in one cache line
+    static const int Arity = 4;
+
+    // Heap slot holding an item and its key
+    struct Node {
+        Key key; // Priority of the item
+        int item; // Vertex number
+    };
+
+    std::vector<Node> nodes; // Heap-ordered slots
+    std::vector<int> position; // Slot of each item, -1 when absent
+
+    // Move the node in the given slot towards the root until the heap order holds
+    void siftUp(int slot) {
+        Node node = nodes[slot];
+        while (slot > 0) {
+            int parent = (slot - 1) / Arity;
+            if (!(node.key < nodes[parent].key))
+                break;
+            nodes[slot] = nodes[parent];
+            position[nodes[slot].item] = slot;
+            slot = parent;
+        }
+        nodes[slot] = node;
+        position[node.item] = slot;
+    }
+
+    // Move the node in the given slot towards the leaves until the heap order holds
+    void siftDown(int slot) {
+        Node node = nodes[slot];
+        int count = static_cast<int>(nodes.size());
+        while (true) {
+            int first = slot * Arity + 1;
+            if (first >= count)
+                break;
+            int last = first + Arity < count ? first + Arity : count;
+            int best = first;
+            for (int child = first + 1; child < last; child++)
+                if (nodes[child].key < nodes[best].key)
+                    best = child;
+            if (!(nodes[best].key < node.key))
+                break;
+            nodes[slot] = nodes[best];
+            position[nodes[slot].item] = slot;
+            slot = best;
+        }
+        nodes[slot] = node;
+        position[node.item] = slot;
+    }
+};
+
+#endif //LABYRINTH_INDEXEDHEAP_H
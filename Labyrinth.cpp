@@ -1,27 +1,197 @@
 #include "Labyrinth.h" // Include the declaration of the Labyrinth class
+#include "Terrain.h" // Include the largest costs of the terrain
 #include <algorithm> // Include the algorithm header for std::reverse
 #include <cmath> // Include the cmath header for mathematical functions
-#include <chrono> // Include the chrono header for time-related functionality
-#include <iostream> // Include the iostream header for input/output operations
+#include <cstdint> // Include the cstdint header for fixed width integers
+#include <cstdlib> // Include the cstdlib header for std::abs
 #include <limits> // Include the limits header for numeric limits
 #include <set> // Include the set header for the set container
 #include <vector> // Include the vector header for the vector container
 
-std::vector<WeightedGraph::Vertex> Labyrinth::Dijkstra(Graph &graph, int start, int end) {
-    // List to store the final path
-    std::vector<Vertex> path;
+const int Labyrinth::NeverBurns;
+
+void Labyrinth::SearchBuffers::reset(int numberV) {
+    // Forget the previous search while keeping the allocated memory
+    timeFromSource.assign(numberV, std::numeric_limits<double>::infinity());
+    prev.assign(numberV, -1);
+    closed.assign((static_cast<size_t>(numberV) + 63) / 64, 0);
+    distanceQueue.reset(numberV);
+    estimateQueue.reset(numberV);
+}
+
+namespace {
+    // Vertex number of the previous vertex in the optimal path, -1 for none
+    int previousOf(const WeightedGraph::Vertex& vertex) {
+        return vertex.prev != nullptr ? vertex.prev->num : -1;
+    }
+
+    // Counters of one search, kept in locals and added to the statistics once at the end
+    struct SearchCounters {
+        long long expanded = 0; // Vertices taken out of the open set
+        long long relaxed = 0; // Edges examined
+        long long pushes = 0; // Insertions and decreases
+        long long pops = 0; // Extractions
+        long long peak = 0; // Largest open set
+
+        void pushed(long long openSize) {
+            pushes++;
+            if (openSize > peak)
+                peak = openSize;
+        }
+
+        void addTo(SolverStats& stats) const {
+            stats.verticesExpanded += expanded;
+            stats.edgesRelaxed += relaxed;
+            stats.heapPushes += pushes;
+            stats.heapPops += pops;
+            if (peak > stats.peakOpenSet)
+                stats.peakOpenSet = peak;
+        }
+    };
+}
+
+PathResult Labyrinth::Dijkstra(Graph &graph, int start, int end, int rows, SolverStats* stats) {
+    // Cells and moves of the final path
+    PathResult path;
+
+    // Initialization of time from source for all vertices to infinity, except the starting point
+    for (Vertex& vertex : graph.vertexList) {
+        vertex.timeFromSource = std::numeric_limits<double>::infinity();
+        vertex.prev = nullptr;
+    }
+    graph.vertexList[start].timeFromSource = 0;
+    SearchCounters counters;
+
+    // Priority queue of discovered vertices, only reachable vertices are ever pushed
+    IndexedHeap<double> to_visit(static_cast<int>(graph.vertexList.size()));
+    to_visit.push(start, 0);
+    counters.pushed(1);
+
+    // Time the search only when statistics are collected
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+
+    // Main loop of the algorithm
+    while (!to_visit.empty()) {
+        // Extract the vertex with the lowest time from the source, its time is now final
+        Vertex* minVertex = &graph.vertexList[to_visit.pop()];
+        counters.pops++;
+
+        // Stop as soon as the end is settled
+        if (minVertex->num == end)
+            break;
+        counters.expanded++;
+
+        // Update time from source for adjacent vertices
+        for (Edge& edge : minVertex->adjacencyList) {
+            int destination = edge.destination;
+            counters.relaxed++;
+            // An edge leaving the graph: the graph is malformed, the path is empty and the caller reports it
+            if (destination < 0 || static_cast<size_t>(destination) >= graph.vertexList.size()) {
+                if (stats != nullptr)
+                    counters.addTo(*stats);
+                return path;
+            }
+
+            // Entering a vertex costs the weight of the edge times the individual time of the vertex
+            Vertex& neighbor = graph.vertexList[destination];
+            double newTime = minVertex->timeFromSource + edge.weight * neighbor.indivTime;
+
+            // Update if a shorter time is found
+            if (newTime < neighbor.timeFromSource) {
+                neighbor.timeFromSource = newTime;
+                neighbor.prev = minVertex;
+                to_visit.push(destination, newTime);
+                counters.pushed(to_visit.size());
+            }
+        }
+    }
+
+    // Report the counters
+    if (stats != nullptr)
+        counters.addTo(*stats);
+
+    // Reconstruct the path from the end
+    path.rebuild(end, rows, [&](int v) { return previousOf(graph.vertexList[v]); });
+
+    return path;
+}
+
+const PathResult& Labyrinth::Dijkstra(const GridGraph& grid, int start, int end, SearchBuffers& buffers) {
+    // Terrain costs are small integers: Dial's buckets instead of a heap of doubles
+    if (grid.edgeOffsets.empty() && grid.weighted()) {
+        buffers.terrainSolver.shortestPath(grid.labels, grid.lines, grid.rows, start, end,
+                                           SmallIntegerCost{grid.costs.data(), Terrain::LargestCost}, buffers.path,
+                                           buffers.stats);
+        return buffers.path;
+    }
+
+    // Cells and moves of the final path
+    PathResult& path = buffers.path;
+    path.clear();
+
+    // Initialization of time from source for all vertices to infinity, except the starting point
+    SolverStats* stats = buffers.stats;
+    SearchCounters counters;
+    buffers.reset(grid.size());
+    buffers.timeFromSource[start] = 0;
+    buffers.distanceQueue.push(start, 0);
+    counters.pushed(1);
+
+    // Time the search only when statistics are collected
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+
+    // Main loop of the algorithm
+    bool found = false;
+    while (!buffers.distanceQueue.empty()) {
+        // Extract the vertex with the lowest time from the source, its time is now final
+        int minVertex = buffers.distanceQueue.pop();
+        counters.pops++;
+        if (minVertex == end) {
+            found = true;
+            break;
+        }
+        counters.expanded++;
+
+        // Update time from source for adjacent vertices
+        double time = buffers.timeFromSource[minVertex];
+        grid.forEachNeighbor(minVertex, [&](int destination, double weight) {
+            counters.relaxed++;
+            double newTime = time + weight;
+            if (newTime < buffers.timeFromSource[destination]) {
+                buffers.timeFromSource[destination] = newTime;
+                buffers.prev[destination] = minVertex;
+                buffers.distanceQueue.push(destination, newTime);
+                counters.pushed(buffers.distanceQueue.size());
+            }
+        });
+    }
+
+    // Report the counters
+    if (stats != nullptr)
+        counters.addTo(*stats);
+
+    // Reconstruct the path from the end
+    if (found)
+        path.rebuild(end, grid.rows, [&](int v) { return buffers.prev[v]; });
+
+    return path;
+}
+
+PathResult Labyrinth::DijkstraLinearScan(Graph &graph, int start, int end, int rows, SolverStats* stats) {
+    // Cells and moves of the final path
+    PathResult path;
 
     // Initialization of time from source for all vertices to infinity, except the starting point
     graph.vertexList[start].timeFromSource = 0;
-    int number_tries = 0;
+    SearchCounters counters;
 
     // Set of vertices to visit
     std::set<Vertex*> to_visit;
     for (Vertex& vertex : graph.vertexList)
         to_visit.insert(&vertex);
 
-    // Measure the start time
-    auto start_time = std::chrono::high_resolution_clock::now();
+    // Time the search only when statistics are collected
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
 
     // Main loop of the algorithm
     while (!to_visit.empty()) {
@@ -38,24 +208,30 @@ std::vector<WeightedGraph::Vertex> Labyrinth::Dijkstra(Graph &graph, int start,
 
         // Check if the minimum vertex is valid
         if (minVertex == nullptr) {
+            if (stats != nullptr)
+                counters.addTo(*stats);
             return path;
         }
 
         // Remove the minimum vertex from the set to visit
         to_visit.erase(minVertex);
-        number_tries++;
+        counters.pops++;
+        counters.expanded++;
 
         // Update time from source for adjacent vertices
         for (Edge& edge : minVertex->adjacencyList) {
             int destination = edge.destination;
-            // Check the validity of the destination index
-            if (destination < 0 || static_cast<size_t>(destination) >= graph.vertexList.size()){
-                std::cout << "Invalid destination index in Dijkstra." << std::endl;
+            counters.relaxed++;
+            // An edge leaving the graph: the graph is malformed, the path is empty and the caller reports it
+            if (destination < 0 || static_cast<size_t>(destination) >= graph.vertexList.size()) {
+                if (stats != nullptr)
+                    counters.addTo(*stats);
                 return path;
             }
 
+            // Entering a vertex costs the weight of the edge times the individual time of the vertex
             Vertex& neighbor = graph.vertexList[destination];
-            double newTime = minVertex->timeFromSource + edge.weight;
+            double newTime = minVertex->timeFromSource + edge.weight * neighbor.indivTime;
 
             // Update if a shorter time is found
             if (newTime < neighbor.timeFromSource) {
@@ -65,98 +241,451 @@ std::vector<WeightedGraph::Vertex> Labyrinth::Dijkstra(Graph &graph, int start,
         }
     }
 
-    // Measure the end time
-    auto end_time = std::chrono::high_resolution_clock::now();
-
-    // Calculate the duration in microseconds
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
-
-    // Output the duration
-    std::cout << "Done ! Using Dijkstra ! Elapsed time : " << duration.count() << " microseconds" << std::endl;
+    // Report the counters
+    if (stats != nullptr)
+        counters.addTo(*stats);
 
     // Reconstruct the path from the end
-    Vertex* current = &graph.vertexList[end];
-    while (current != nullptr) {
-        path.push_back(*current);
-        current = current->prev;
-    }
-    std::reverse(path.begin(), path.end());
+    path.rebuild(end, rows, [&](int v) { return previousOf(graph.vertexList[v]); });
 
     return path;
 }
 
-std::vector<WeightedGraph::Vertex> Labyrinth::AStar(Graph& graph, int start, int end, int rows, int numberV) {
-    // List to store the final path
-    std::vector<Vertex> path;
+PathResult Labyrinth::AStar(Graph& graph, int start, int end, int rows, int numberV, SolverStats* stats) {
+    // Cells and moves of the final path
+    PathResult path;
 
     // Initialization of time from source for all vertices to infinity, except the starting point
-    graph.vertexList[start].timeFromSource = 0;
-    int number_tries = 0;
-
-    // Set of vertices to visit
-    std::set<int> to_visit;
-    for (Vertex& vertex : graph.vertexList)
-        to_visit.insert(vertex.num);
-
-    // Calculate heuristics for each vertex
-    // It takes into account the coordinates (i % rows, i / rows) of the current vertex
-    // And the coordinates (end % rows, end / rows) of the destination point
-    int i = 0;
+    // Heuristics are reset to -1 and computed on first discovery only
     for (Vertex& vertex : graph.vertexList) {
-        vertex.heuristic = distance(i % rows, i / rows, end % rows, end / rows);
-        i++;
+        vertex.timeFromSource = std::numeric_limits<double>::infinity();
+        vertex.heuristic = -1;
+        vertex.prev = nullptr;
     }
+    graph.vertexList[start].timeFromSource = 0;
+    graph.vertexList[start].heuristic = manhattanDistance(start % rows, start / rows, end % rows, end / rows);
+    SearchCounters counters;
+
+    // Open list of discovered vertices and bit-packed closed set of expanded vertices
+    IndexedHeap<AStarKey> to_visit(static_cast<int>(graph.vertexList.size()));
+    std::vector<uint64_t> closed((graph.vertexList.size() + 63) / 64, 0);
+    to_visit.push(start, AStarKey{graph.vertexList[start].heuristic, 0});
+    counters.pushed(1);
 
-    // Measure the start time
-    auto start_time = std::chrono::high_resolution_clock::now();
+    // Time the search only when statistics are collected
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
 
     // Main loop of the A* algorithm
-    while (to_visit.count(end) > 0) {
-        // Find the vertex with the smallest value of timeFromSource + heuristic
-        int min_v = 0;
-        double timeFromSourceHeuristicMinimal = std::numeric_limits<double>::infinity();
-
-        for (int vertexNum : to_visit) {
-            if ((graph.vertexList[vertexNum].timeFromSource + graph.vertexList[vertexNum].heuristic) <= timeFromSourceHeuristicMinimal) {
-                min_v = vertexNum;
-                timeFromSourceHeuristicMinimal = graph.vertexList[vertexNum].timeFromSource + graph.vertexList[vertexNum].heuristic;
-            }
-        }
+    bool found = false;
+    while (!to_visit.empty()) {
+        // Expand the vertex with the smallest value of timeFromSource + heuristic
+        int min_v = to_visit.pop();
+        closed[min_v >> 6] |= uint64_t(1) << (min_v & 63);
+        counters.pops++;
 
-        // Add the current vertex to the path
-        path.push_back(graph.vertexList[min_v]);
-        to_visit.erase(min_v);
-        number_tries += 1;
+        if (min_v == end) {
+            found = true;
+            break;
+        }
+        counters.expanded++;
 
         // Update timeFromSource values for adjacent vertices
         for (const auto& edge : graph.vertexList[min_v].adjacencyList) {
             int to_try = edge.destination;
-            if (to_visit.count(to_try) > 0) {
-                bool move = canMove(to_try, graph.vertexList, numberV);
-
-                if (move) { // Prisoner moved
-                    double newTime = graph.vertexList[min_v].timeFromSource + edge.weight;
-                    if (newTime < graph.vertexList[to_try].timeFromSource) {
-                        graph.vertexList[to_try].timeFromSource = newTime;
-                        graph.vertexList[to_try].prev = &graph.vertexList[min_v];
-                    }
+            counters.relaxed++;
+            if (closed[to_try >> 6] & (uint64_t(1) << (to_try & 63)))
+                continue; // Already expanded, its time is final
+
+            if (canMove(to_try, graph.vertexList, numberV)) { // Prisoner can go there
+                Vertex& neighbor = graph.vertexList[to_try];
+                double newTime = graph.vertexList[min_v].timeFromSource + edge.weight * neighbor.indivTime;
+                if (newTime < neighbor.timeFromSource) {
+                    // The Manhattan distance never overestimates while every weight and individual time is at least 1
+                    if (neighbor.heuristic < 0)
+                        neighbor.heuristic = manhattanDistance(to_try % rows, to_try / rows, end % rows, end / rows);
+                    neighbor.timeFromSource = newTime;
+                    neighbor.prev = &graph.vertexList[min_v];
+                    to_visit.push(to_try, AStarKey{newTime + neighbor.heuristic, newTime});
+                    counters.pushed(to_visit.size());
                 }
             }
         }
     }
 
-    // Measure the end time
-    auto end_time = std::chrono::high_resolution_clock::now();
+    // Report the counters
+    if (stats != nullptr)
+        counters.addTo(*stats);
 
-    // Calculate the duration in microseconds
-    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time);
+    // Reconstruct the path from the end, empty when the end cannot be reached
+    if (found)
+        path.rebuild(end, rows, [&](int v) { return previousOf(graph.vertexList[v]); });
+
+    return path;
+}
 
-    // Output the duration
-    std::cout << "Done ! Using A* ! Elapsed time : " << duration.count() << " microseconds" << std::endl;
+namespace {
+    // A* on the implicit grid of a terrain with Dial's buckets by estimate instead of a heap: costs and Manhattan distances
+    // are integers, and since entering a cell costs at least 1 the estimate never drops along a move and grows by at most
+    // the largest cost + 1. Fills timeFromSource and prev, return true when the end is reached
+    bool terrainAStar(const WeightedGraph::GridGraph& grid, int start, int end, Labyrinth::SearchBuffers& buffers,
+                      SearchCounters& counters) {
+        int rows = grid.rows, endX = end % rows, endY = end / rows;
+        buffers.buckets.reset(grid.size(), Terrain::LargestCost + 1);
+        buffers.timeFromSource[start] = 0;
+        buffers.buckets.push(start, Labyrinth::manhattanDistance(start % rows, start / rows, endX, endY));
+        counters.pushed(1);
+
+        while (!buffers.buckets.empty()) {
+            int v = buffers.buckets.pop();
+            counters.pops++;
+            if (buffers.isClosed(v))
+                continue; // Older entry of a cell whose time dropped
+            buffers.close(v);
+            if (v == end)
+                return true;
+            counters.expanded++;
+            int time = static_cast<int>(buffers.timeFromSource[v]);
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                counters.relaxed++;
+                if (buffers.isClosed(neighbor) || !Labyrinth::canMove(neighbor, grid.labels, grid.size()))
+                    return;
+                int next = time + grid.costs[neighbor];
+                if (next >= buffers.timeFromSource[neighbor])
+                    return;
+                buffers.timeFromSource[neighbor] = next;
+                buffers.prev[neighbor] = v;
+                buffers.buckets.push(neighbor, next + Labyrinth::manhattanDistance(neighbor % rows, neighbor / rows, endX, endY));
+                counters.pushed(static_cast<long long>(buffers.buckets.size()));
+            });
+        }
+        return false;
+    }
+}
+
+const PathResult& Labyrinth::AStar(const GridGraph& grid, int start, int end, SearchBuffers& buffers) {
+    // Cells and moves of the final path
+    PathResult& path = buffers.path;
+    path.clear();
+    int rows = grid.rows;
+
+    // Terrain costs are small integers, so are the estimates: Dial's buckets instead of the heap of AStarKey
+    if (grid.edgeOffsets.empty() && grid.weighted()) {
+        SearchCounters counters;
+        buffers.reset(grid.size());
+        PhaseTimer timer(buffers.stats != nullptr ? &buffers.stats->searchNanoseconds : nullptr);
+        bool found = terrainAStar(grid, start, end, buffers, counters);
+        if (buffers.stats != nullptr)
+            counters.addTo(*buffers.stats);
+        if (found)
+            path.rebuild(end, rows, [&](int v) { return buffers.prev[v]; });
+        return path;
+    }
+
+    // Initialization of time from source for all vertices to infinity, except the starting point
+    SolverStats* stats = buffers.stats;
+    SearchCounters counters;
+    buffers.reset(grid.size());
+    buffers.timeFromSource[start] = 0;
+    int endX = end % rows, endY = end / rows;
+    buffers.estimateQueue.push(start, AStarKey{static_cast<double>(manhattanDistance(start % rows, start / rows, endX, endY)), 0});
+    counters.pushed(1);
+
+    // Time the search only when statistics are collected
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+
+    // Main loop of the A* algorithm
+    bool found = false;
+    while (!buffers.estimateQueue.empty()) {
+        // Expand the vertex with the smallest value of timeFromSource + heuristic
+        int min_v = buffers.estimateQueue.pop();
+        buffers.close(min_v);
+        counters.pops++;
+        if (min_v == end) {
+            found = true;
+            break;
+        }
+        counters.expanded++;
+
+        // Update timeFromSource values for adjacent vertices the prisoner can enter
+        double time = buffers.timeFromSource[min_v];
+        grid.forEachNeighbor(min_v, [&](int to_try, double weight) {
+            counters.relaxed++;
+            if (buffers.isClosed(to_try) || !canMove(to_try, grid.labels, grid.size()))
+                return;
+            double newTime = time + weight;
+            if (newTime < buffers.timeFromSource[to_try]) {
+                buffers.timeFromSource[to_try] = newTime;
+                buffers.prev[to_try] = min_v;
+                int heuristic = manhattanDistance(to_try % rows, to_try / rows, endX, endY);
+                buffers.estimateQueue.push(to_try, AStarKey{newTime + heuristic, newTime});
+                counters.pushed(buffers.estimateQueue.size());
+            }
+        });
+    }
+
+    // Report the counters
+    if (stats != nullptr)
+        counters.addTo(*stats);
+
+    // Reconstruct the path from the end, empty when the end cannot be reached
+    if (found)
+        path.rebuild(end, rows, [&](int v) { return buffers.prev[v]; });
 
     return path;
 }
 
+const PathResult& Labyrinth::BreadthFirstSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers) {
+    // Explicit edges and terrain may be weighted, only the plain implicit grid has unit costs
+    if (!grid.edgeOffsets.empty() || grid.weighted())
+        return AStar(grid, start, end, buffers);
+    buffers.unitSolver.shortestPath(grid.labels, grid.lines, grid.rows, start, end, UnitCost(), buffers.path, buffers.stats);
+    return buffers.path;
+}
+
+namespace {
+    // Jumps of Jump Point Search on a 4-connected grid
+    // Optimal paths are taken in the canonical form that moves vertically as early as possible:
+    // a vertical run may turn to either side at any cell, a horizontal run only turns where the cell
+    // diagonally behind it is blocked, since otherwise the same turn one cell earlier is as short
+    struct JumpScanner {
+        const std::vector<char>& labels; // Cell labels
+        int lines; // Number of lines of the grid
+        int rows; // Number of cells per line
+        int end; // Goal cell
+
+        // Check if the prisoner can enter the cell of line i and column j, false outside the grid
+        bool walkable(int i, int j) const {
+            if (i < 0 || i >= lines || j < 0 || j >= rows)
+                return false;
+            char label = labels[i * rows + j];
+            return label == '.' || label == 'S';
+        }
+
+        // Run from (i, j) along the line in direction dx, return the first jump point or -1 at a dead end
+        int horizontal(int i, int j, int dx) const {
+            while (true) {
+                j += dx;
+                if (!walkable(i, j))
+                    return -1;
+                int cell = i * rows + j;
+                if (cell == end)
+                    return cell;
+                // Forced vertical neighbour: it is free while the cell above or below the previous one is blocked
+                if ((walkable(i - 1, j) && !walkable(i - 1, j - dx)) || (walkable(i + 1, j) && !walkable(i + 1, j - dx)))
+                    return cell;
+            }
+        }
+
+        // Run from (i, j) along the column in direction dy, a cell is a jump point when a horizontal run from it finds one
+        int vertical(int i, int j, int dy) const {
+            while (true) {
+                i += dy;
+                if (!walkable(i, j))
+                    return -1;
+                int cell = i * rows + j;
+                if (cell == end || horizontal(i, j, 1) != -1 || horizontal(i, j, -1) != -1)
+                    return cell;
+            }
+        }
+    };
+}
+
+const PathResult& Labyrinth::JumpPointSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers) {
+    // Explicit edges have no grid geometry to jump along, terrain costs break the symmetry of the runs
+    if (!grid.edgeOffsets.empty() || grid.weighted())
+        return AStar(grid, start, end, buffers);
+
+    // Cells and moves of the final path
+    PathResult& path = buffers.path;
+    path.clear();
+    int rows = grid.rows;
+    JumpScanner scanner{grid.labels, grid.lines, rows, end};
+
+    // Initialization of time from source for all vertices to infinity, except the starting point
+    // buffers.prev holds the previous jump point of each queued cell
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+    SearchCounters counters;
+    buffers.reset(grid.size());
+    buffers.timeFromSource[start] = 0;
+    int endX = end % rows, endY = end / rows;
+    buffers.estimateQueue.push(start, AStarKey{static_cast<double>(manhattanDistance(start % rows, start / rows, endX, endY)), 0});
+    counters.pushed(1);
+
+    // Main loop of the A* algorithm over the jump points
+    bool found = false;
+    while (!buffers.estimateQueue.empty()) {
+        int current = buffers.estimateQueue.pop();
+        buffers.close(current);
+        counters.pops++;
+        if (current == end) {
+            found = true;
+            break;
+        }
+        counters.expanded++;
+
+        // Directions kept after pruning: every direction from the start, the run continued
+        // and both sides after a vertical move, the run continued and the forced turns after a horizontal one
+        int i = current / rows, j = current % rows;
+        int parent = buffers.prev[current];
+        int successors[4], count = 0;
+        if (parent == -1) {
+            successors[count++] = scanner.vertical(i, j, 1);
+            successors[count++] = scanner.vertical(i, j, -1);
+            successors[count++] = scanner.horizontal(i, j, 1);
+            successors[count++] = scanner.horizontal(i, j, -1);
+        } else if (parent % rows == j) {
+            int dy = current > parent ? 1 : -1;
+            successors[count++] = scanner.vertical(i, j, dy);
+            successors[count++] = scanner.horizontal(i, j, 1);
+            successors[count++] = scanner.horizontal(i, j, -1);
+        } else {
+            int dx = current > parent ? 1 : -1;
+            successors[count++] = scanner.horizontal(i, j, dx);
+            if (scanner.walkable(i - 1, j) && !scanner.walkable(i - 1, j - dx))
+                successors[count++] = scanner.vertical(i, j, -1);
+            if (scanner.walkable(i + 1, j) && !scanner.walkable(i + 1, j - dx))
+                successors[count++] = scanner.vertical(i, j, 1);
+        }
+
+        // Queue the jump points, a straight run costs its length
+        double time = buffers.timeFromSource[current];
+        for (int k = 0; k < count; k++) {
+            int next = successors[k];
+            if (next == -1 || buffers.isClosed(next))
+                continue;
+            counters.relaxed++;
+            double newTime = time + manhattanDistance(j, i, next % rows, next / rows);
+            if (newTime < buffers.timeFromSource[next]) {
+                buffers.timeFromSource[next] = newTime;
+                buffers.prev[next] = current;
+                int heuristic = manhattanDistance(next % rows, next / rows, endX, endY);
+                buffers.estimateQueue.push(next, AStarKey{newTime + heuristic, newTime});
+                counters.pushed(buffers.estimateQueue.size());
+            }
+        }
+    }
+
+    // Report the counters
+    if (stats != nullptr)
+        counters.addTo(*stats);
+
+    // Fill the cells between consecutive jump points, then rebuild the path cell by cell
+    if (found) {
+        buffers.frontier.clear();
+        for (int current = end; current != -1; current = buffers.prev[current])
+            buffers.frontier.push_back(current);
+        for (size_t k = buffers.frontier.size() - 1; k > 0; k--) {
+            int from = buffers.frontier[k], to = buffers.frontier[k - 1];
+            int step = from / rows == to / rows ? (to > from ? 1 : -1) : (to > from ? rows : -rows);
+            for (int cell = from + step; cell != to + step; cell += step)
+                buffers.prev[cell] = cell - step;
+        }
+        path.rebuild(end, rows, [&](int v) { return buffers.prev[v]; });
+    }
+
+    return path;
+}
+
+const PathResult& Labyrinth::BidirectionalSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers) {
+    // Explicit edges may be one-way or weighted, terrain is weighted, the search from the exit needs neither
+    if (!grid.edgeOffsets.empty() || grid.weighted())
+        return AStar(grid, start, end, buffers);
+
+    // Cells and moves of the final path
+    PathResult& path = buffers.path;
+    path.clear();
+
+    // Moves from the start in buffers.arrival, moves to the exit in buffers.backward
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+    SearchCounters counters;
+    int numberV = grid.size();
+    buffers.arrival.assign(numberV, -1);
+    buffers.prev.assign(numberV, -1);
+    buffers.backward.assign(numberV, -1);
+    buffers.next.assign(numberV, -1);
+    buffers.frontier.assign(1, start);
+    buffers.backwardFrontier.assign(1, end);
+    buffers.arrival[start] = 0;
+    buffers.backward[end] = 0;
+    size_t head = 0, backHead = 0;
+
+    // Expand one whole level of the smaller side at a time. Before a level the cells within k moves of the start
+    // and within j moves of the exit are disjoint, so a shortest path has more than k + j moves,
+    // and any cell found by both sides during the level closes a path of at most k + 1 + j moves
+    int meeting = start == end ? end : -1;
+    while (meeting == -1 && head < buffers.frontier.size() && backHead < buffers.backwardFrontier.size()) {
+        bool forward = buffers.frontier.size() - head <= buffers.backwardFrontier.size() - backHead;
+        std::vector<int>& queue = forward ? buffers.frontier : buffers.backwardFrontier;
+        std::vector<int>& own = forward ? buffers.arrival : buffers.backward;
+        std::vector<int>& other = forward ? buffers.backward : buffers.arrival;
+        std::vector<int>& link = forward ? buffers.prev : buffers.next;
+        size_t& position = forward ? head : backHead;
+
+        for (size_t levelEnd = queue.size(); position < levelEnd && meeting == -1; position++) {
+            int v = queue[position];
+            int step = own[v] + 1;
+            counters.expanded++;
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                if (meeting != -1)
+                    return;
+                counters.relaxed++;
+                if (own[neighbor] != -1)
+                    return;
+                // Both sides go through the cells the prisoner can enter, the other side's cells (start or exit) included
+                if (other[neighbor] == -1 && !canMove(neighbor, grid.labels, numberV))
+                    return;
+                own[neighbor] = step;
+                link[neighbor] = v;
+                if (other[neighbor] != -1)
+                    meeting = neighbor;
+                else
+                    queue.push_back(neighbor);
+            });
+        }
+
+        long long open = static_cast<long long>(buffers.frontier.size() - head + buffers.backwardFrontier.size() - backHead);
+        if (open > counters.peak)
+            counters.peak = open;
+    }
+
+    // Report the counters, every queued cell is pushed and popped once
+    if (stats != nullptr) {
+        counters.pushes = static_cast<long long>(buffers.frontier.size() + buffers.backwardFrontier.size());
+        counters.pops = counters.expanded;
+        counters.addTo(*stats);
+    }
+
+    // Chain the cells after the meeting point to their predecessors, then rebuild the path from the end
+    if (meeting != -1) {
+        for (int current = meeting; current != end; current = buffers.next[current])
+            buffers.prev[buffers.next[current]] = current;
+        path.rebuild(end, grid.rows, [&](int v) { return buffers.prev[v]; });
+    }
+
+    return path;
+}
+
+const PathResult& Labyrinth::HierarchicalSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers) {
+    // Explicit edges have no clusters, the cluster distances count moves, not terrain costs
+    if (!grid.edgeOffsets.empty() || grid.weighted())
+        return AStar(grid, start, end, buffers);
+
+    // The abstraction is built on the threads of the parallel engine when there is one
+    if (!buffers.hierarchy.builtFor(grid.labels, grid.lines, grid.rows)) {
+        int threads = buffers.parallel != nullptr ? buffers.parallel->threadCount() : 1;
+        buffers.hierarchy.build(grid.labels, grid.lines, grid.rows, HierarchicalPlanner::DefaultClusterSize, threads);
+    }
+    buffers.hierarchy.findPath(start, end, buffers.path, buffers.stats);
+    return buffers.path;
+}
+
+int Labyrinth::manhattanDistance(int xa, int ya, int xb, int yb) {
+    // Calculate the Manhattan distance between two points
+    return std::abs(xb - xa) + std::abs(yb - ya);
+}
+
 double Labyrinth::distance(int xa, int ya, int xb, int yb) {
     // Calculate the Euclidean distance between two points
     double resultX = std::pow((xb - xa), 2);  // Calculate the squared difference in the x-coordinates
@@ -165,42 +694,272 @@ double Labyrinth::distance(int xa, int ya, int xb, int yb) {
     return std::sqrt(resultX + resultY);  // Return the square root of the sum of squared differences
 }
 
-bool Labyrinth::canMove(int vertex_num, const std::vector<Vertex>& vertexList, int numberV) {
-    // Check if the vertex number is valid
-    if (vertex_num < numberV) {
-        // Retrieve the current vertex from the list of vertices
-        const Vertex& currentVertex = vertexList[vertex_num];
 
-        // Check if the label of the vertex is an empty point or a starting point
-        return currentVertex.label == '.' || currentVertex.label == 'S';
-    } else {
-        // The vertex number is invalid; the prisoner cannot move
-        return false;
+namespace {
+    // Access to the label of a cell, stored either in a vertex or directly as a char
+    char& labelOf(WeightedGraph::Vertex& vertex) { return vertex.label; }
+    char labelOf(const WeightedGraph::Vertex& vertex) { return vertex.label; }
+    char& labelOf(char& label) { return label; }
+    char labelOf(const char& label) { return label; }
+
+    // Check if the prisoner can enter a cell
+    template <typename Cell>
+    bool canMoveOn(int vertex_num, const std::vector<Cell>& cells, int numberV) {
+        // Check if the vertex number is valid
+        if (vertex_num < numberV) {
+            // Check if the label of the vertex is an empty point or a starting point
+            return labelOf(cells[vertex_num]) == '.' || labelOf(cells[vertex_num]) == 'S';
+        } else {
+            // The vertex number is invalid; the prisoner cannot move
+            return false;
+        }
+    }
+
+    // Check if the prisoner is next to the exit
+    template <typename Cell>
+    bool winMoveOn(int start, const std::vector<Cell>& cells, int lines, int rows) {
+        int i = start / rows, j = start % rows;
+        // Check if the prisoner can move to the cell on the left and if that cell contains the exit
+        bool left = j != 0 && labelOf(cells[start - 1]) == 'S';
+        // Check if the prisoner can move to the cell on the right and if that cell contains the exit
+        bool right = j != (rows - 1) && labelOf(cells[start + 1]) == 'S';
+        // Check if the prisoner can move to the cell above and if that cell contains the exit
+        bool top = i != 0 && labelOf(cells[start - rows]) == 'S';
+        // Check if the prisoner can move to the cell below and if that cell contains the exit
+        bool bottom = i != (lines - 1) && labelOf(cells[start + rows]) == 'S';
+
+        // The prisoner wins if they can exit through the top, left, right, or bottom
+        return top || left || right || bottom;
+    }
+
+    // Move the prisoner one cell in the given direction, return true if they reach the exit
+    template <typename Cell>
+    bool movePrisonerOn(char movementDirection, std::vector<Cell>& cells, int lines, int rows) {
+        // Move the prisoner based on the given movement direction
+        int start = 0;
+
+        // Find the current position of the prisoner
+        for (size_t i = 0; i < cells.size(); i++) {
+            if (labelOf(cells[i]) == 'D')
+                start = static_cast<int>(i);
+        }
+
+        // Check for victory
+        bool victory = winMoveOn(start, cells, lines, rows);
+
+        // Return true if victorious
+        if (victory)
+            return true;
+        else {
+            labelOf(cells[start]) = 'L'; // Mark the current position as passed
+
+            // Move the prisoner according to the direction
+            int newStart = start; // Initialize the new position to the current position
+
+            if (movementDirection == 'U' && (start + rows < static_cast<int>(cells.size()))) {
+                newStart = start + rows; // Move the prisoner upwards
+            } else if (movementDirection == 'T' && (start - rows >= 0)) {
+                newStart = start - rows; // Move the prisoner downwards
+            } else if (movementDirection == 'L' && (start % rows != 0)) {
+                newStart = start - 1; // Move the prisoner to the left
+            } else if (movementDirection == 'R' && ((start + 1) % rows != 0)) {
+                newStart = start + 1; // Move the prisoner to the right
+            }
+
+            // Check if the movement is possible
+            if (canMoveOn(newStart, cells, lines * rows)) {
+                labelOf(cells[newStart]) = 'D'; // Move the prisoner to the new position
+                return false; // Successful movement
+            } else {
+                labelOf(cells[start]) = 'D'; // Invalid movement, the prisoner stays where they are
+                return false;
+            }
+        }
+    }
+
+    // Check if the fire can spread into a cell: walls never burn, burning cells are left unchanged
+    bool canIgnite(char label) {
+        return label != '#' && label != 'F' && label != 'A';
+    }
+
+    // Set a cell on fire for the next turn, return true if it holds the prisoner or the exit
+    template <typename Cell>
+    bool ignite(Cell& cell) {
+        bool lose = labelOf(cell) == 'D' || labelOf(cell) == 'S';
+        labelOf(cell) = 'A'; // Prevent fire from spreading again in the same turn
+        return lose;
+    }
+
+    // Spread the fire to the cells around a burning cell
+    template <typename Cell>
+    bool firePropagationOn(int vertexNum, std::vector<Cell>& cells, int lines, int rows) {
+        // Propagate the fire around a given vertex, updating adjacent cells
+        bool lose = false;
+
+        // Check and update the cell to the left
+        if (vertexNum % rows != 0 && canIgnite(labelOf(cells[vertexNum - 1])))
+            lose = ignite(cells[vertexNum - 1]) || lose;
+
+        // Check and update the cell to the right
+        if ((vertexNum + 1) % rows != 0 && canIgnite(labelOf(cells[vertexNum + 1])))
+            lose = ignite(cells[vertexNum + 1]) || lose;
+
+        // Check and update the cell above
+        if (vertexNum >= rows && canIgnite(labelOf(cells[vertexNum - rows])))
+            lose = ignite(cells[vertexNum - rows]) || lose;
+
+        // Check and update the cell below
+        if (vertexNum < (lines - 1) * rows && canIgnite(labelOf(cells[vertexNum + rows])))
+            lose = ignite(cells[vertexNum + rows]) || lose;
+
+        // Return true if the fire reaches the prisoner or the exit in this turn
+        return lose;
+    }
+
+    // Play the planned moves turn by turn against the fire and return 'Y' or 'N'
+    template <typename Cell>
+    char simulate(std::vector<Cell>& cells, const std::vector<char>& directions, int lines, int rows, int& turn) {
+        turn = 0;
+
+        while (turn < static_cast<int>(directions.size())) {
+            // Update fire states on the graph
+            for (auto & cell : cells) {
+                if (labelOf(cell) == 'A') // Fire movement
+                    labelOf(cell) = 'F'; // Fire
+            }
+
+            // Fire propagation and check for game over
+            turn++;
+            for (size_t i = 0; i < cells.size(); i++) {
+                if (labelOf(cells[i]) == 'F') {
+                    if (firePropagationOn(static_cast<int>(i), cells, lines, rows))
+                        return 'N'; // Lost
+                }
+            }
+
+            // Move the prisoner
+            if (movePrisonerOn(directions[turn - 1], cells, lines, rows))
+                return 'Y'; // Won
+        }
+
+        return 'N'; // Lost
+    }
+
+    // Same game as simulate with the fire kept in bitsets: labels are only read, the prisoner position is tracked
+    char simulateBitboard(const WeightedGraph::GridGraph& grid, const std::vector<char>& directions, FireBitboard& board,
+                          int& turns) {
+        int lines = grid.lines, rows = grid.rows, numberV = grid.size();
+        board.load(grid.labels, lines, rows);
+
+        // Find the prisoner and the exits once
+        int start = 0;
+        std::vector<int> exits;
+        for (int v = 0; v < numberV; v++) {
+            if (grid.labels[v] == 'D')
+                start = v;
+            else if (grid.labels[v] == 'S')
+                exits.push_back(v);
+        }
+
+        turns = 0;
+        for (size_t turn = 0; turn < directions.size(); turn++) {
+            // Fire propagation and check for game over
+            turns++;
+            board.spread();
+            if (board.ignitedLastTurn(start))
+                return 'N'; // Lost
+            for (int exit : exits)
+                if (board.ignitedLastTurn(exit))
+                    return 'N'; // Lost
+
+            // Check for victory
+            if (winMoveOn(start, grid.labels, lines, rows))
+                return 'Y'; // Won
+
+            // Move the prisoner according to the direction, they stay in place if the move is not possible
+            board.markTrail(start);
+            char movementDirection = directions[turn];
+            int newStart = start;
+            if (movementDirection == 'U' && start + rows < numberV)
+                newStart = start + rows;
+            else if (movementDirection == 'T' && start - rows >= 0)
+                newStart = start - rows;
+            else if (movementDirection == 'L' && start % rows != 0)
+                newStart = start - 1;
+            else if (movementDirection == 'R' && (start + 1) % rows != 0)
+                newStart = start + 1;
+
+            if (canMoveOn(newStart, grid.labels, numberV) && !board.isBurning(newStart) && !board.isTrail(newStart))
+                start = newStart;
+        }
+
+        return 'N'; // Lost
     }
 }
 
+bool Labyrinth::canMove(int vertex_num, const std::vector<Vertex>& vertexList, int numberV) {
+    return canMoveOn(vertex_num, vertexList, numberV);
+}
+
+bool Labyrinth::canMove(int vertex_num, const std::vector<char>& labels, int numberV) {
+    return canMoveOn(vertex_num, labels, numberV);
+}
+
 std::vector<char> Labyrinth::MovementDirectionForEachTurn(Graph& graph, int start, int end, int rows, int numberV) {
-    // Calculate the optimal path using the A* algorithm
-    std::vector<Vertex> path = AStar(graph, start, end, rows, numberV);
-    Dijkstra(graph, start, end);
+    // Calculate the optimal path using the A* algorithm, its moves are already encoded
+    return AStar(graph, start, end, rows, numberV).directions();
+}
+
+std::vector<char> Labyrinth::MovementDirectionForEachTurn(const GridGraph& grid, int start, int end, SearchBuffers& buffers,
+                                                          PathSearch search) {
+    // Calculate the optimal path using the chosen search, its moves are already encoded
+    if (search == PathSearch::BreadthFirst)
+        return BreadthFirstSearch(grid, start, end, buffers).directions();
+    if (search == PathSearch::JumpPoint)
+        return JumpPointSearch(grid, start, end, buffers).directions();
+    if (search == PathSearch::Bidirectional)
+        return BidirectionalSearch(grid, start, end, buffers).directions();
+    if (search == PathSearch::Hierarchical && grid.edgeOffsets.empty() && !grid.weighted()) {
+        // The buffers may hold the abstraction of another instance of the same size
+        int threads = buffers.parallel != nullptr ? buffers.parallel->threadCount() : 1;
+        buffers.hierarchy.build(grid.labels, grid.lines, grid.rows, HierarchicalPlanner::DefaultClusterSize, threads);
+        return HierarchicalSearch(grid, start, end, buffers).directions();
+    }
+    if (search == PathSearch::Incremental && !grid.weighted()) {
+        // Without closed cells the D* Lite plan is followed to the exit as is
+        std::vector<int> cells(1, start);
+        buffers.planner.reset(grid.labels, grid.lines, grid.rows, start, end, buffers.stats);
+        for (int next = buffers.planner.nextMove(); next != -1; next = buffers.planner.nextMove()) {
+            cells.push_back(next);
+            if (next == end)
+                break;
+            buffers.planner.moveStart(next);
+        }
+        return cells.back() == end ? movementDirections(cells, grid.rows) : std::vector<char>();
+    }
+    return AStar(grid, start, end, buffers).directions();
+}
 
+std::vector<char> Labyrinth::movementDirections(const std::vector<int>& path, int rows) {
     // List to store movement directions
     std::vector<char> directions;
+    directions.reserve(path.empty() ? 0 : path.size() - 1);
 
     // Traverse the path to determine movement directions between each pair of vertices
-    for (size_t i = 0; i < (path.size() - 1); i++) {
+    for (size_t i = 0; i + 1 < path.size(); i++) {
         // Calculate the movement between two adjacent vertices
-        int movement = path[i + 1].num - path[i].num;
+        int movement = path[i + 1] - path[i];
 
         // Assign the corresponding direction based on the movement
-        if (movement == 1)
-            directions.push_back('R'); // Right
-        else if (movement == -1)
-            directions.push_back('L'); // Left
-        else if (movement == rows)
+        // Vertical moves are tested first: with a single cell per line they also differ by 1
+        if (movement == rows)
             directions.push_back('U'); // Up
         else if (movement == (-1 * rows))
             directions.push_back('T'); // Down
+        else if (movement == 1)
+            directions.push_back('R'); // Right
+        else if (movement == -1)
+            directions.push_back('L'); // Left
         else
             return directions; // Stop if the movement is not recognized
     }
@@ -209,129 +968,743 @@ std::vector<char> Labyrinth::MovementDirectionForEachTurn(Graph& graph, int star
 }
 
 bool Labyrinth::movePrisoner(char movementDirection, std::vector<Vertex> &vertexList, int lines, int rows) {
-    // Move the prisoner based on the given movement direction
-    int start = 0;
+    return movePrisonerOn(movementDirection, vertexList, lines, rows);
+}
 
-    // Find the current position of the prisoner
-    for (size_t i = 0; i < vertexList.size(); i++) {
-        if (vertexList[i].label == 'D')
-            start = static_cast<int>(i);
-    }
+bool Labyrinth::movePrisoner(char movementDirection, std::vector<char> &labels, int lines, int rows) {
+    return movePrisonerOn(movementDirection, labels, lines, rows);
+}
+
+bool Labyrinth::winMove(int start, const std::vector<Vertex>& vertexList, int lines, int rows) {
+    return winMoveOn(start, vertexList, lines, rows);
+}
+
+bool Labyrinth::winMove(int start, const std::vector<char>& labels, int lines, int rows) {
+    return winMoveOn(start, labels, lines, rows);
+}
+
+bool Labyrinth::firePropagationAround(int vertexNum, std::vector<Vertex>& vertexList, int lines, int rows) {
+    return firePropagationOn(vertexNum, vertexList, lines, rows);
+}
+
+bool Labyrinth::firePropagationAround(int vertexNum, std::vector<char>& labels, int lines, int rows) {
+    return firePropagationOn(vertexNum, labels, lines, rows);
+}
+
+char Labyrinth::runInstance(Graph& graph, int start, int end, int lines, int rows) {
+    // Run an instance of the labyrinth game and return the result ('Y' for win, 'N' for lose)
+    // Calculate movement directions for each turn
+    std::vector<char> directions = MovementDirectionForEachTurn(graph, start, end, rows, lines * rows);
+
+    // Play the moves on a copy of the labels, the graph stays reusable
+    std::vector<char> labels(graph.vertexList.size());
+    for (size_t v = 0; v < labels.size(); v++)
+        labels[v] = graph.vertexList[v].label;
+    int turns = 0;
+    return simulate(labels, directions, lines, rows, turns);
+}
 
-    // Check for victory
-    bool victory = winMove(start, vertexList, lines, rows);
+char Labyrinth::runInstance(const GridGraph& grid, int start, int end, SearchBuffers& buffers, FireKernel kernel,
+                            PathSearch search) {
+    // Run an instance of the labyrinth game on the compact grid
+    if (search == PathSearch::Incremental)
+        return replanInstance(grid, start, end, buffers);
 
-    // Return true if victorious
-    if (victory)
-        return true;
-    else {
-        vertexList[start].label = 'L'; // Mark the current position as passed
+    // Calculate movement directions for each turn
+    std::vector<char> directions = MovementDirectionForEachTurn(grid, start, end, buffers, search);
 
-        // Move the prisoner according to the direction
-        int newStart = start; // Initialize the new position to the current position
+    return replayInstance(grid, directions, buffers, kernel);
+}
 
-        if (movementDirection == 'U' && (start + rows < static_cast<int>(vertexList.size()))) {
-            newStart = start + rows; // Move the prisoner upwards
-        } else if (movementDirection == 'T' && (start - rows >= 0)) {
-            newStart = start - rows; // Move the prisoner downwards
-        } else if (movementDirection == 'L' && (start % rows != 0)) {
-            newStart = start - 1; // Move the prisoner to the left
-        } else if (movementDirection == 'R' && ((start + 1) % rows != 0)) {
-            newStart = start + 1; // Move the prisoner to the right
+char Labyrinth::replayInstance(const GridGraph& grid, const std::vector<char>& directions, SearchBuffers& buffers, FireKernel kernel) {
+    // Play the given moves against the grid, which is only read, with the state of the chosen kernel
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->simulationNanoseconds : nullptr);
+    int turns = 0;
+    char result;
+    if (kernel == FireKernel::Fronts) {
+        // The prisoner is the last 'D', as for the other kernels
+        int start = 0;
+        for (int v = 0; v < grid.size(); v++)
+            if (grid.labels[v] == 'D')
+                start = v;
+        buffers.simulation.reset(grid, start);
+        result = buffers.simulation.play(directions, turns);
+    } else if (kernel == FireKernel::Bitboard) {
+        result = simulateBitboard(grid, directions, buffers.fireBoard, turns);
+    } else {
+        buffers.labels.assign(grid.labels.begin(), grid.labels.end());
+        result = simulate(buffers.labels, directions, grid.lines, grid.rows, turns);
+    }
+    if (stats != nullptr)
+        stats->simulationTurns += turns;
+    return result;
+}
+
+char Labyrinth::replanInstance(const GridGraph& grid, int start, int end, SearchBuffers& buffers) {
+    // Play on the copy of the labels held by the buffers, the burning front in buffers.frontier
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->simulationNanoseconds : nullptr);
+    int lines = grid.lines, rows = grid.rows, numberV = grid.size();
+    std::vector<char>& labels = buffers.labels;
+    labels.assign(grid.labels.begin(), grid.labels.end());
+    buffers.frontier.clear();
+    for (int v = 0; v < numberV; v++)
+        if (labels[v] == 'F')
+            buffers.frontier.push_back(v);
+    buffers.planner.reset(labels, lines, rows, start, end, stats);
+
+    int turn = 0;
+    char result = 'N';
+    size_t head = 0;
+    while (true) {
+        // Fire propagation from the cells that caught fire on the previous turn, the others have no free neighbour left
+        turn++;
+        size_t front = buffers.frontier.size();
+        bool lost = false;
+        for (size_t k = head; k < front; k++)
+            labels[buffers.frontier[k]] = 'F';
+        auto burn = [&](int neighbor) {
+            if (!canIgnite(labels[neighbor]))
+                return;
+            lost = ignite(labels[neighbor]) || lost;
+            buffers.frontier.push_back(neighbor);
+            buffers.planner.close(neighbor);
+        };
+        for (; head < front; head++) {
+            int v = buffers.frontier[head];
+            if (v % rows != 0)
+                burn(v - 1);
+            if ((v + 1) % rows != 0)
+                burn(v + 1);
+            if (v >= rows)
+                burn(v - rows);
+            if (v < (lines - 1) * rows)
+                burn(v + rows);
         }
+        if (lost)
+            break; // Lost
 
-        // Check if the movement is possible
-        if (canMove(newStart, vertexList, lines * rows)) {
-            vertexList[newStart].label = 'D'; // Move the prisoner to the new position
-            return false; // Successful movement
-        } else {
-            return false; // Invalid movement
+        // Check for victory
+        if (winMoveOn(start, labels, lines, rows)) {
+            result = 'Y'; // Won
+            break;
         }
+
+        // Move the prisoner along the repaired plan, the trail behind them closes
+        int next = buffers.planner.nextMove();
+        if (next == -1)
+            break; // Lost, cells only ever close so the exit stays out of reach
+        labels[start] = 'L';
+        labels[next] = 'D';
+        buffers.planner.moveStart(next);
+        buffers.planner.close(start);
+        start = next;
     }
+
+    if (stats != nullptr)
+        stats->simulationTurns += turn;
+    return result;
 }
 
-bool Labyrinth::winMove(int start, const std::vector<Vertex>& vertexList, int lines, int rows) {
-    // Check if the prisoner can move to the cell on the left and if that cell contains the exit
-    bool left = vertexList[start].j != 0 && (vertexList[start - 1].label == 'S');
-    // Check if the prisoner can move to the cell on the right and if that cell contains the exit
-    bool right = vertexList[start].j != (rows - 1) && (vertexList[start + 1].label == 'S');
-    // Check if the prisoner can move to the cell above and if that cell contains the exit
-    bool top = vertexList[start].i != 0 && vertexList[start - rows].label == 'S';
-    // Check if the prisoner can move to the cell below and if that cell contains the exit
-    bool bottom = vertexList[start].i != (lines - 1) && vertexList[start + rows].label == 'S';
+namespace {
+    // Dial's version of fireArrivalTimes for terrain: a cell ignites fireDelays turns after its first burning neighbour
+    void terrainFireArrivalTimes(const WeightedGraph::GridGraph& grid, Labyrinth::SearchBuffers& buffers, SearchCounters& counters) {
+        int numberV = grid.size();
+        std::vector<int>& ignition = buffers.ignition;
+        ignition.assign(numberV, Labyrinth::NeverBurns);
+        buffers.closed.assign((static_cast<size_t>(numberV) + 63) / 64, 0);
+        buffers.buckets.reset(numberV, Terrain::LargestDelay);
+        for (int v = 0; v < numberV; v++) {
+            if (grid.labels[v] == 'F') {
+                ignition[v] = 0;
+                buffers.buckets.push(v, 0);
+                counters.pushed(static_cast<long long>(buffers.buckets.size()));
+            }
+        }
+
+        while (!buffers.buckets.empty()) {
+            int v = buffers.buckets.pop();
+            counters.pops++;
+            if (buffers.isClosed(v))
+                continue; // Older entry of a cell that ignites earlier
+            buffers.close(v);
+            counters.expanded++;
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                counters.relaxed++;
+                if (grid.labels[neighbor] == '#' || buffers.isClosed(neighbor))
+                    return;
+                int turn = ignition[v] + grid.fireDelays[neighbor];
+                if (turn < ignition[neighbor]) {
+                    ignition[neighbor] = turn;
+                    buffers.buckets.push(neighbor, turn);
+                    counters.pushed(static_cast<long long>(buffers.buckets.size()));
+                }
+            });
+        }
+    }
 
-    // The prisoner wins if they can exit through the top, left, right, or bottom
-    return top || left || right || bottom;
+    // Dial's version of the prisoner's search of escapeDecision for terrain: crossing a cell takes its cost in turns,
+    // the prisoner must leave a '.' cell before it ignites and reach the exit before it ignites. Return true on escape
+    bool terrainPrisonerSearch(const WeightedGraph::GridGraph& grid, int start, int end, Labyrinth::SearchBuffers& buffers,
+                               SearchCounters& counters) {
+        int numberV = grid.size();
+        const std::vector<int>& ignition = buffers.ignition;
+        buffers.arrival.assign(numberV, -1);
+        buffers.prev.assign(numberV, -1);
+        buffers.closed.assign((static_cast<size_t>(numberV) + 63) / 64, 0);
+        buffers.buckets.reset(numberV, Terrain::LargestCost);
+        buffers.arrival[start] = 0;
+        buffers.buckets.push(start, 0);
+        counters.pushed(1);
+
+        while (!buffers.buckets.empty()) {
+            int v = buffers.buckets.pop();
+            counters.pops++;
+            if (buffers.isClosed(v))
+                continue; // Older entry of a cell reached earlier
+            buffers.close(v);
+            if (v == end)
+                return true;
+            counters.expanded++;
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                counters.relaxed++;
+                if (buffers.isClosed(neighbor))
+                    return;
+                int next = buffers.arrival[v] + grid.costs[neighbor];
+                if (buffers.arrival[neighbor] != -1 && buffers.arrival[neighbor] <= next)
+                    return;
+                bool safe = neighbor == end ? ignition[end] > next
+                                            : grid.labels[neighbor] == '.' && ignition[neighbor] > next + 1;
+                if (!safe)
+                    return;
+                buffers.arrival[neighbor] = next;
+                buffers.prev[neighbor] = v;
+                buffers.buckets.push(neighbor, next);
+                counters.pushed(static_cast<long long>(buffers.buckets.size()));
+            });
+        }
+        return false;
+    }
+
+    // Radix heap version of exitDeadlines for terrain: the latest turn of a cell is min(ignition - 2, latest of a
+    // neighbour - cost of that neighbour). The latest turns drop by more than one per move and by ignition jumps,
+    // so cells are queued by distance below the largest latest turn of the exits, which only grows
+    void terrainExitDeadlines(const WeightedGraph::GridGraph& grid, Labyrinth::SearchBuffers& buffers, SearchCounters& counters) {
+        int numberV = grid.size();
+        std::vector<int>& backward = buffers.backward;
+        buffers.closed.assign((static_cast<size_t>(numberV) + 63) / 64, 0);
+        buffers.latestQueue.clear();
+        int top = 0;
+        for (int v = 0; v < numberV; v++) {
+            if (grid.labels[v] == 'S') {
+                backward[v] = buffers.ignition[v] - 1;
+                if (backward[v] > top)
+                    top = backward[v];
+            }
+        }
+        for (int v = 0; v < numberV; v++) {
+            if (grid.labels[v] == 'S' && backward[v] >= 1) {
+                buffers.latestQueue.push(v, static_cast<uint32_t>(top - backward[v]));
+                counters.pushed(static_cast<long long>(buffers.latestQueue.size()));
+            }
+        }
+
+        while (!buffers.latestQueue.empty()) {
+            uint32_t key = 0;
+            int v = buffers.latestQueue.pop(key);
+            counters.pops++;
+            if (buffers.isClosed(v))
+                continue; // Older entry of a cell whose latest turn grew
+            buffers.close(v);
+            counters.expanded++;
+            int latest = backward[v] - grid.costs[v];
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                counters.relaxed++;
+                char label = grid.labels[neighbor];
+                if (buffers.isClosed(neighbor) || (label != '.' && label != 'D'))
+                    return;
+                int candidate = buffers.ignition[neighbor] - 2 < latest ? buffers.ignition[neighbor] - 2 : latest;
+                if (candidate < 0 || candidate <= backward[neighbor])
+                    return;
+                backward[neighbor] = candidate;
+                buffers.next[neighbor] = v;
+                buffers.latestQueue.push(neighbor, static_cast<uint32_t>(top - candidate));
+                counters.pushed(static_cast<long long>(buffers.latestQueue.size()));
+            });
+        }
+    }
 }
 
-bool Labyrinth::firePropagationAround(int vertexNum, std::vector<Vertex>& vertexList, int lines, int rows) {
-    // Propagate the fire around a given vertex, updating adjacent cells
-    bool lose = false;
+namespace {
+    // The unit-cost searches below only use labels, size() and forEachNeighbor, so they run on a row-major GridGraph
+    // or on a TiledGrid; the arrays of buffers are indexed by the cells of the grid given
+
+    // Multi-source breadth-first search of the fire from every 'F' cell, walls never burn
+    template <typename Grid>
+    void unitFireArrivalTimes(const Grid& grid, Labyrinth::SearchBuffers& buffers, SearchCounters& counters) {
+        int numberV = grid.size();
+        buffers.ignition.assign(numberV, Labyrinth::NeverBurns);
+        buffers.frontier.clear();
+        for (int v = 0; v < numberV; v++) {
+            if (grid.labels[v] == 'F') {
+                buffers.ignition[v] = 0;
+                buffers.frontier.push_back(v);
+            }
+        }
 
-    // Check and update the cell to the left of the prisoner
-    if (vertexNum % rows != 0 && vertexList[vertexNum - 1].label != 'F') {
-        vertexList[vertexNum - 1].label = 'A'; // Prevent fire from being in the same cell
-        if (vertexList[vertexNum - 1].label == 'S') {
-            lose = true;
+        size_t head = 0;
+        for (; head < buffers.frontier.size(); head++) {
+            int v = buffers.frontier[head];
+            int next = buffers.ignition[v] + 1;
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                counters.relaxed++;
+                if (buffers.ignition[neighbor] == Labyrinth::NeverBurns && grid.labels[neighbor] != '#') {
+                    buffers.ignition[neighbor] = next;
+                    buffers.frontier.push_back(neighbor);
+                }
+            });
+            if (buffers.frontier.size() - head > static_cast<size_t>(counters.peak))
+                counters.peak = static_cast<long long>(buffers.frontier.size() - head);
         }
+
+        // Every queued cell was expanded
+        counters.expanded = counters.pushes = counters.pops = static_cast<long long>(head);
     }
 
-    // Check and update the cell to the right of the prisoner
-    if ((vertexNum + 1) % rows != 0 && vertexList[vertexNum + 1].label != 'F') {
-        vertexList[vertexNum + 1].label = 'A';
-        if (vertexList[vertexNum + 1].label == 'S') {
-            lose = true;
+    // Breadth-first search of the prisoner of escapeDecision through cells reached strictly before the fire,
+    // buffers.ignition must be filled. Return true when the exit is reached, buffers.prev then holds the route
+    template <typename Grid>
+    bool unitPrisonerSearch(const Grid& grid, int start, int end, Labyrinth::SearchBuffers& buffers, SearchCounters& counters) {
+        int numberV = grid.size();
+        buffers.arrival.assign(numberV, -1);
+        buffers.prev.assign(numberV, -1);
+        buffers.frontier.clear();
+        buffers.arrival[start] = 0;
+        buffers.frontier.push_back(start);
+
+        bool escaped = false;
+        size_t head = 0;
+        for (; head < buffers.frontier.size() && !escaped; head++) {
+            int v = buffers.frontier[head];
+            int next = buffers.arrival[v] + 1;
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                if (escaped)
+                    return;
+                counters.relaxed++;
+                if (buffers.arrival[neighbor] != -1)
+                    return;
+                if (neighbor == end) {
+                    // The exit must still be free when the prisoner steps on it
+                    if (buffers.ignition[end] > next) {
+                        buffers.arrival[end] = next;
+                        buffers.prev[end] = v;
+                        escaped = true;
+                    }
+                } else if (grid.labels[neighbor] == '.' && buffers.ignition[neighbor] > next + 1) {
+                    // The cell must survive the fire spreading before the next move
+                    buffers.arrival[neighbor] = next;
+                    buffers.prev[neighbor] = v;
+                    buffers.frontier.push_back(neighbor);
+                }
+            });
+            if (buffers.frontier.size() - head > static_cast<size_t>(counters.peak))
+                counters.peak = static_cast<long long>(buffers.frontier.size() - head);
         }
+
+        counters.expanded = counters.pops = static_cast<long long>(head);
+        counters.pushes = static_cast<long long>(buffers.frontier.size());
+        return escaped;
     }
 
-    // Check and update the cell above the prisoner
-    if (vertexNum >= rows && vertexList[vertexNum - rows].label != 'F') {
-        vertexList[vertexNum - rows].label = 'A';
-        if (vertexList[vertexNum - rows].label == 'S') {
-            lose = true;
+    // Latest safe turn of every cell from every exit for exitDeadlines, buffers.ignition must be filled
+    // The cells are taken from buckets of decreasing latest turn
+    template <typename Grid>
+    void unitExitDeadlines(const Grid& grid, Labyrinth::SearchBuffers& buffers, SearchCounters& counters) {
+        int numberV = grid.size();
+        buffers.backward.assign(numberV, -1);
+        buffers.next.assign(numberV, -1);
+        buffers.bucketLinks.assign(numberV, -1);
+
+        // An exit can be stepped on until the turn before it ignites
+        // No escape takes numberV moves or more, later turns are all as good as never burning
+        int top = 0;
+        for (int v = 0; v < numberV; v++) {
+            if (grid.labels[v] == 'S') {
+                int latest = buffers.ignition[v] - 1 < numberV ? buffers.ignition[v] - 1 : numberV;
+                buffers.backward[v] = latest;
+                if (latest > top)
+                    top = latest;
+            }
+        }
+        buffers.bucketHeads.assign(static_cast<size_t>(top) + 1, -1);
+        auto insert = [&](int cell, int latest) {
+            buffers.bucketLinks[cell] = buffers.bucketHeads[latest];
+            buffers.bucketHeads[latest] = cell;
+            counters.pushes++;
+        };
+        for (int v = 0; v < numberV; v++)
+            if (grid.labels[v] == 'S' && buffers.backward[v] >= 1)
+                insert(v, buffers.backward[v]);
+
+        // Cells are taken by decreasing latest turn, so the first neighbour reaching a cell gives it its final value:
+        // one turn before the neighbour's, or two turns before the cell ignites if that is earlier.
+        // New values are always smaller than the bucket being read, and cells of turn 0 reach no one
+        for (int latest = top; latest >= 1; latest--) {
+            for (int v = buffers.bucketHeads[latest]; v != -1; v = buffers.bucketLinks[v]) {
+                counters.expanded++;
+                grid.forEachNeighbor(v, [&](int neighbor, double) {
+                    counters.relaxed++;
+                    char label = grid.labels[neighbor];
+                    if (buffers.backward[neighbor] != -1 || (label != '.' && label != 'D'))
+                        return;
+                    int candidate = buffers.ignition[neighbor] - 2 < latest - 1 ? buffers.ignition[neighbor] - 2 : latest - 1;
+                    if (candidate < 0)
+                        return;
+                    buffers.backward[neighbor] = candidate;
+                    buffers.next[neighbor] = v;
+                    insert(neighbor, candidate);
+                });
+            }
         }
+
+        // Every bucketed cell was expanded once
+        counters.pops = counters.expanded;
+    }
+}
+
+void Labyrinth::fireArrivalTimes(const GridGraph& grid, SearchBuffers& buffers) {
+    // Multi-source breadth-first search from every burning cell, walls never burn
+    // Large grids are searched by the parallel engine when one is attached
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->fireNanoseconds : nullptr);
+    if (grid.weighted()) {
+        SearchCounters counters;
+        terrainFireArrivalTimes(grid, buffers, counters);
+        if (stats != nullptr)
+            counters.addTo(*stats);
+        return;
+    }
+    if (buffers.parallel != nullptr && grid.size() >= ParallelBfs::MinimumCells) {
+        buffers.parallel->fireArrivalTimes(grid, buffers.ignition, NeverBurns);
+        return;
+    }
+
+    SearchCounters counters;
+    unitFireArrivalTimes(grid, buffers, counters);
+    if (stats != nullptr)
+        counters.addTo(*stats);
+}
+
+void Labyrinth::fireArrivalTimes(const TiledGrid& grid, SearchBuffers& buffers) {
+    // The same breadth-first search with the cells in tiled order, always serial
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->fireNanoseconds : nullptr);
+    SearchCounters counters;
+    unitFireArrivalTimes(grid, buffers, counters);
+    if (stats != nullptr)
+        counters.addTo(*stats);
+}
+
+char Labyrinth::escapeDecision(const GridGraph& grid, int start, int end, SearchBuffers& buffers, std::vector<int>* route) {
+    // First pass: turn at which each cell catches fire
+    fireArrivalTimes(grid, buffers);
+    if (route != nullptr)
+        route->clear();
+
+    // The fire spreads before the prisoner's first move, they must survive it
+    if (buffers.ignition[start] <= 1)
+        return 'N';
+
+    // Second pass: breadth-first search from the prisoner through cells reached strictly before the fire
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+    SearchCounters counters;
+    int numberV = grid.size();
+    bool escaped = false;
+    if (grid.weighted()) {
+        // Terrain: the prisoner's cells leave a bucket queue in order of arrival turn
+        escaped = terrainPrisonerSearch(grid, start, end, buffers, counters);
+    } else if (buffers.parallel != nullptr && numberV >= ParallelBfs::MinimumCells) {
+        escaped = buffers.parallel->prisonerArrivalTimes(grid, start, end, buffers.ignition, buffers.arrival, buffers.prev);
+    } else {
+        escaped = unitPrisonerSearch(grid, start, end, buffers, counters);
     }
 
-    // Check and update the cell below the prisoner
-    if (vertexNum < (lines - 1) * rows && vertexList[vertexNum + rows].label != 'F') {
-        vertexList[vertexNum + rows].label = 'A';
-        if (vertexList[vertexNum + rows].label == 'S') {
-            lose = true;
+    // Report the counters of the serial searches
+    if (stats != nullptr)
+        counters.addTo(*stats);
+
+    if (!escaped)
+        return 'N';
+
+    // Rebuild the escape route from the predecessors
+    if (route != nullptr) {
+        for (int current = end; current != -1; current = buffers.prev[current])
+            route->push_back(current);
+        std::reverse(route->begin(), route->end());
+    }
+    return 'Y';
+}
+
+char Labyrinth::escapeDecision(const TiledGrid& grid, int start, int end, SearchBuffers& buffers, std::vector<int>* route) {
+    // The same two passes on the tiled cells, the prisoner and the exit are given and returned in row-major numbers
+    fireArrivalTimes(grid, buffers);
+    if (route != nullptr)
+        route->clear();
+    int first = grid.cellOf(start), exit = grid.cellOf(end);
+    if (buffers.ignition[first] <= 1)
+        return 'N';
+
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+    SearchCounters counters;
+    bool escaped = unitPrisonerSearch(grid, first, exit, buffers, counters);
+    if (stats != nullptr)
+        counters.addTo(*stats);
+    if (!escaped)
+        return 'N';
+
+    if (route != nullptr) {
+        for (int current = exit; current != -1; current = buffers.prev[current])
+            route->push_back(grid.rowMajorOf(current));
+        std::reverse(route->begin(), route->end());
+    }
+    return 'Y';
+}
+
+char Labyrinth::bidirectionalEscapeDecision(const GridGraph& grid, int start, int end, SearchBuffers& buffers,
+                                            std::vector<int>* route) {
+    // Explicit edges may be one-way, the search from the exit needs the reverse moves; terrain is decided by a bucket queue
+    if (!grid.edgeOffsets.empty() || grid.weighted())
+        return escapeDecision(grid, start, end, buffers, route);
+
+    // First pass: turn at which each cell catches fire
+    fireArrivalTimes(grid, buffers);
+    if (route != nullptr)
+        route->clear();
+
+    // The fire spreads before the prisoner's first move, they must survive it
+    if (buffers.ignition[start] <= 1)
+        return 'N';
+
+    // Second pass: earliest turns from the prisoner in buffers.arrival, breadth-first,
+    // latest turns toward the exit in buffers.backward, largest first through buffers.distanceQueue
+    SolverStats* stats = buffers.stats;
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+    SearchCounters counters;
+    int numberV = grid.size();
+    buffers.arrival.assign(numberV, -1);
+    buffers.prev.assign(numberV, -1);
+    buffers.backward.assign(numberV, -1);
+    buffers.next.assign(numberV, -1);
+    buffers.distanceQueue.reset(numberV);
+    buffers.frontier.assign(1, start);
+    buffers.arrival[start] = 0;
+    size_t head = 0;
+
+    // No escape takes numberV moves or more, later turns are all as good as never burning
+    int exitLatest = buffers.ignition[end] - 1 < numberV ? buffers.ignition[end] - 1 : numberV;
+    if (exitLatest >= 1) {
+        buffers.backward[end] = exitLatest;
+        buffers.distanceQueue.push(end, -exitLatest);
+        counters.pushed(1);
+    }
+
+    // Alternate between a level of the prisoner and a cell of the exit side, whichever is smaller
+    // Each side alone decides the instance: the prisoner's by stepping on the exit, the exit's by reaching the start,
+    // so the prisoner is trapped as soon as either side runs out of cells
+    int meeting = -1;
+    while (meeting == -1 && head < buffers.frontier.size() && !buffers.distanceQueue.empty()) {
+        bool forward = buffers.frontier.size() - head <= static_cast<size_t>(buffers.distanceQueue.size());
+        if (forward) {
+            for (size_t levelEnd = buffers.frontier.size(); head < levelEnd && meeting == -1; head++) {
+                int v = buffers.frontier[head];
+                int next = buffers.arrival[v] + 1;
+                counters.expanded++;
+                counters.pops++;
+                grid.forEachNeighbor(v, [&](int neighbor, double) {
+                    if (meeting != -1)
+                        return;
+                    counters.relaxed++;
+                    if (buffers.arrival[neighbor] != -1)
+                        return;
+                    if (neighbor == end) {
+                        // The exit must still be free when the prisoner steps on it
+                        if (buffers.ignition[end] > next) {
+                            buffers.arrival[end] = next;
+                            buffers.prev[end] = v;
+                            meeting = end;
+                        }
+                    } else if (grid.labels[neighbor] == '.' && buffers.ignition[neighbor] > next + 1) {
+                        // The cell must survive the fire spreading before the next move
+                        buffers.arrival[neighbor] = next;
+                        buffers.prev[neighbor] = v;
+                        if (buffers.backward[neighbor] >= next) {
+                            meeting = neighbor;
+                        } else {
+                            buffers.frontier.push_back(neighbor);
+                            counters.pushed(static_cast<long long>(buffers.frontier.size() - head));
+                        }
+                    }
+                });
+            }
+        } else {
+            // A neighbour stepping into v must stand on its cell one turn before v's latest turn
+            int v = buffers.distanceQueue.pop();
+            int latest = buffers.backward[v] - 1;
+            counters.expanded++;
+            counters.pops++;
+            grid.forEachNeighbor(v, [&](int neighbor, double) {
+                if (meeting != -1)
+                    return;
+                counters.relaxed++;
+                if (grid.labels[neighbor] != '.' && neighbor != start)
+                    return;
+                int candidate = neighbor == start || buffers.ignition[neighbor] - 2 > latest ? latest
+                                                                                            : buffers.ignition[neighbor] - 2;
+                if (candidate <= buffers.backward[neighbor])
+                    return;
+                buffers.backward[neighbor] = candidate;
+                buffers.next[neighbor] = v;
+                if (buffers.arrival[neighbor] != -1 && buffers.arrival[neighbor] <= candidate) {
+                    meeting = neighbor;
+                } else {
+                    buffers.distanceQueue.push(neighbor, -candidate);
+                    counters.pushed(buffers.distanceQueue.size());
+                }
+            });
         }
     }
 
-    // Return true if the fire reaches the prisoner in this turn
-    return lose;
+    // Report the counters
+    if (stats != nullptr)
+        counters.addTo(*stats);
+
+    if (meeting == -1)
+        return 'N';
+
+    // The prisoner follows their own search to the meeting point, then the latest turns to the exit
+    if (route != nullptr) {
+        for (int current = meeting; current != -1; current = buffers.prev[current])
+            route->push_back(current);
+        std::reverse(route->begin(), route->end());
+        for (int current = buffers.next[meeting]; current != -1; current = buffers.next[current])
+            route->push_back(current);
+    }
+    return 'Y';
 }
 
-char Labyrinth::runInstance(Graph graph, int start, int end, int lines, int rows) {
-    // Run an instance of the labyrinth game and return the result ('Y' for win, 'N' for lose)
-    int turn = 0;
+void Labyrinth::exitDeadlines(const GridGraph& grid, SearchBuffers& buffers) {
+    SolverStats* stats = buffers.stats;
+    SearchCounters counters;
+    if (grid.weighted()) {
+        int numberV = grid.size();
+        buffers.backward.assign(numberV, -1);
+        buffers.next.assign(numberV, -1);
+        terrainExitDeadlines(grid, buffers, counters);
+    } else {
+        unitExitDeadlines(grid, buffers, counters);
+    }
+    if (stats != nullptr)
+        counters.addTo(*stats);
+}
 
-    // Calculate movement directions for each turn
-    std::vector<char> directions = MovementDirectionForEachTurn(graph, start, end, rows, lines * rows);
+void Labyrinth::escapeDecisions(const GridGraph& grid, SearchBuffers& buffers, std::string& results,
+                                std::vector<std::vector<int>>* routes) {
+    results.clear();
+    if (routes != nullptr)
+        routes->clear();
+    int numberV = grid.size();
 
-    while (turn < static_cast<int>(directions.size())) {
-        // Update fire states on the graph
-        for (auto & vertex : graph.vertexList) {
-            if (vertex.label == 'A') // Fire movement
-                vertex.label = 'F'; // Fire
+    // Explicit edges may be one-way, the pass from the exits needs the reverse moves
+    if (!grid.edgeOffsets.empty()) {
+        int end = -1;
+        for (int v = 0; v < numberV && end == -1; v++)
+            if (grid.labels[v] == 'S')
+                end = v;
+        for (int v = 0; v < numberV; v++) {
+            if (grid.labels[v] != 'D')
+                continue;
+            std::vector<int> route;
+            results += end == -1 ? 'N' : escapeDecision(grid, v, end, buffers, routes != nullptr ? &route : nullptr);
+            if (routes != nullptr)
+                routes->push_back(route);
         }
+        return;
+    }
 
-        // Fire propagation and check for game over
-        for (size_t i = 0; i < graph.vertexList.size(); i++) {
-            if (graph.vertexList[i].label == 'F') {
-                if (firePropagationAround(static_cast<int>(i), graph.vertexList, lines, rows))
-                    return 'N'; // Lost
-            }
+    // First pass: turn at which each cell catches fire, from every 'F' cell
+    fireArrivalTimes(grid, buffers);
+
+    // Second pass: latest safe turn of every cell, from every exit
+    SolverStats* stats = buffers.stats;
+    {
+        PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+        exitDeadlines(grid, buffers);
+    }
+
+    // A prisoner escapes when they may stand on their cell at turn 0, which also means it ignites after turn 1
+    for (int v = 0; v < numberV; v++) {
+        if (grid.labels[v] != 'D')
+            continue;
+        bool escapes = buffers.backward[v] >= 0;
+        results += escapes ? 'Y' : 'N';
+        if (routes != nullptr) {
+            routes->push_back(std::vector<int>());
+            if (escapes)
+                for (int current = v; current != -1; current = buffers.next[current])
+                    routes->back().push_back(current);
         }
+    }
+}
 
-        // Move the prisoner
-        if (movePrisoner(directions[turn], graph.vertexList, lines, rows))
-            return 'Y'; // Won
+void Labyrinth::escapeDecisions(const TiledGrid& grid, SearchBuffers& buffers, std::string& results,
+                                std::vector<std::vector<int>>* routes) {
+    // The same two passes on the tiled cells, the prisoners are listed in row-major order
+    results.clear();
+    if (routes != nullptr)
+        routes->clear();
+    fireArrivalTimes(grid, buffers);
+    SolverStats* stats = buffers.stats;
+    {
+        PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+        SearchCounters counters;
+        unitExitDeadlines(grid, buffers, counters);
+        if (stats != nullptr)
+            counters.addTo(*stats);
+    }
 
-        turn++;
+    for (int i = 0; i < grid.lines; i++) {
+        for (int j = 0; j < grid.rows; j++) {
+            int v = grid.cellOf(i, j);
+            if (grid.labels[v] != 'D')
+                continue;
+            bool escapes = buffers.backward[v] >= 0;
+            results += escapes ? 'Y' : 'N';
+            if (routes != nullptr) {
+                routes->push_back(std::vector<int>());
+                if (escapes)
+                    for (int current = v; current != -1; current = buffers.next[current])
+                        routes->back().push_back(grid.rowMajorOf(current));
+            }
+        }
     }
+}
 
-    return 'N'; // Lost
+void Labyrinth::decideInstance(const GridGraph& grid, long long prisoners, long long exits, int start, int end,
+                               SearchBuffers& buffers, std::string& results) {
+    // escapeDecision only looks for end, the other exits would be walls to it
+    bool single = prisoners == 1 && exits == 1;
+    if (TiledGrid::suits(grid) && (buffers.parallel == nullptr || grid.size() < ParallelBfs::MinimumCells)) {
+        buffers.tiled.assign(grid);
+        if (single)
+            results.assign(1, escapeDecision(buffers.tiled, start, end, buffers));
+        else
+            escapeDecisions(buffers.tiled, buffers, results);
+    } else if (single) {
+        results.assign(1, escapeDecision(grid, start, end, buffers));
+    } else {
+        escapeDecisions(grid, buffers, results);
+    }
 }
@@ -2,40 +2,234 @@
 #define LABYRINTH_LABYRINTH_H
 
 #include "WeightedGraph.h" // Include the declaration of the WeightedGraph class
+#include "IndexedHeap.h" // Include the indexed heap used as priority queue
+#include "FireBitboard.h" // Include the bit-parallel fire propagation kernel
+#include "ParallelBfs.h" // Include the parallel breadth-first search engine
+#include "PathResult.h" // Include the index based path result
+#include "SolverStats.h" // Include the solver statistics
+#include "IncrementalPlanner.h" // Include the D* Lite planner of the replanning simulation
+#include "HierarchicalPlanner.h" // Include the cluster abstraction of the hierarchical search
+#include "GridSolver.h" // Include the searches specialised on the moves and the cost model
+#include "SimulationState.h" // Include the per-turn state of the simulation played on a read-only grid
+#include "RadixHeap.h" // Include the monotone queue of the latest turns on terrain
+#include "TiledGrid.h" // Include the cache-blocked copy of a grid
+#include <cstdint> // Fixed width integers
 #include <iostream> // Input/output stream functionality
 #include <vector> // Dynamic array functionality using vectors
 #include <list> // Linked list functionality
+#include <string> // String manipulation functions
 #include <set> // Set container functionality
 
 // Class representing a labyrinth, derived from WeightedGraph
 class Labyrinth : public WeightedGraph {
 public:
-    // Dijkstra's algorithm for finding the shortest path in the labyrinth
-    static std::vector<WeightedGraph::Vertex> Dijkstra(Graph &graph, int start, int end);
+    // Ignition turn of the cells the fire never reaches
+    static const int NeverBurns = 0x7fffffff;
 
-    // A* algorithm for finding the optimal path in the labyrinth
-    static std::vector<Vertex> AStar(Graph& graph, int start, int end, int rows, int numberV);
+    // Fire propagation used by the turn by turn simulation
+    enum class FireKernel {
+        Fronts, // Double-buffered fire fronts of a SimulationState, the labels of the grid are only read
+        Labels, // One cell at a time through a copy of the labels ('A' then 'F'), kept to cross-check the other kernels
+        Bitboard // Whole lines at a time through FireBitboard
+    };
+
+    // Path search used to choose the moves of the turn by turn simulation
+    enum class PathSearch {
+        AStar, // A* over every cell
+        BreadthFirst, // Breadth-first search compiled for 4 neighbours and unit costs
+        JumpPoint, // Jump Point Search over the jump points of the 4-connected grid
+        Bidirectional, // Breadth-first searches from the prisoner and from the exit until they meet
+        Incremental, // D* Lite, the turn by turn simulation repairs the plan after every spread of the fire
+        Hierarchical // HPA* over a cluster abstraction built for the instance, near-optimal paths
+    };
+
+    // Priority of an open vertex in A*: lowest estimate first, deepest vertex first among equal estimates
+    struct AStarKey {
+        double estimate; // timeFromSource + heuristic
+        double timeFromSource; // Time from the source to the vertex
+
+        bool operator<(const AStarKey& other) const {
+            if (estimate != other.estimate)
+                return estimate < other.estimate;
+            return timeFromSource > other.timeFromSource;
+        }
+    };
+
+    // Reusable scratch state of the searches on a GridGraph, stored as separate arrays
+    class SearchBuffers {
+    public:
+        std::vector<double> timeFromSource; // Time from the source to each vertex
+        std::vector<int> prev; // Previous vertex in the optimal path, -1 for none
+        std::vector<uint64_t> closed; // Bit set of the expanded vertices
+        IndexedHeap<double> distanceQueue; // Open vertices ordered by time from source
+        IndexedHeap<AStarKey> estimateQueue; // Open vertices ordered by A* estimate
+        std::vector<int> ignition; // Turn at which each cell catches fire, NeverBurns when it never does
+        std::vector<int> arrival; // Turn at which the prisoner reaches each cell, -1 when not reached
+        std::vector<int> frontier; // Flat FIFO queue of the breadth-first searches
+        std::vector<int> backward; // Value of each cell in the search from the exit, -1 when not reached
+        std::vector<int> next; // Next vertex toward the exit in the search from the exit, -1 for none
+        std::vector<int> backwardFrontier; // Flat FIFO queue of the breadth-first search from the exit
+        std::vector<int> bucketHeads; // First cell of each latest turn in exitDeadlines, -1 for none
+        std::vector<int> bucketLinks; // Next cell of the same latest turn in exitDeadlines, -1 for none
+        BucketQueue<int> buckets; // Dial's buckets of the fire and of the prisoner on terrain, by turn
+        RadixHeap<int> latestQueue; // Cells of exitDeadlines on terrain, by distance below the largest latest turn
+        std::vector<char> labels; // Copy of the labels played by the turn by turn simulation
+        PathResult path; // Path of the last Dijkstra or A* search
+        FireBitboard fireBoard; // Fire, walls and trail bitsets of the bitboard simulation
+        SimulationState simulation; // Fire fronts, trail and prisoner of the simulation with the fronts kernel
+        TiledGrid tiled; // Tiled copy of the wide grids decided by the batch mode
+        IncrementalPlanner planner; // D* Lite state of the replanning simulation
+        HierarchicalPlanner hierarchy; // Cluster abstraction of the hierarchical search
+        GridSolver<FourConnected, UnitCost> unitSolver; // Breadth-first search of the unit-cost grids
+        GridSolver<FourConnected, SmallIntegerCost> terrainSolver; // Dijkstra on Dial's buckets of the terrain grids
+        ParallelBfs* parallel = nullptr; // Engine searching large grids on several threads, null for serial searches
+        SolverStats* stats = nullptr; // Statistics of the searches run with these buffers, null to collect none
+
+        // Prepare the buffers for a search over numberV vertices, memory is kept between searches
+        void reset(int numberV);
+
+        // Check and mark the expanded vertices
+        bool isClosed(int vertexNum) const {
+            return (closed[vertexNum >> 6] >> (vertexNum & 63)) & 1;
+        }
+        void close(int vertexNum) {
+            closed[vertexNum >> 6] |= uint64_t(1) << (vertexNum & 63);
+        }
+    };
+
+    // Dijkstra's algorithm for finding the shortest path in the labyrinth, rows is the number of cells per line
+    // Entering a vertex costs the weight of the edge times the individual time of the vertex, in every search on a Graph
+    // An edge to a vertex outside the graph gives an empty path, nothing is printed
+    static PathResult Dijkstra(Graph &graph, int start, int end, int rows, SolverStats* stats = nullptr);
+
+    // Dijkstra's algorithm on a compact grid, the path is stored in buffers.path until the next search
+    // Entering a cell of an implicit grid costs its terrain cost. Terrain grids run on Dial's buckets through
+    // GridSolver<FourConnected, SmallIntegerCost>, where the prisoner only enters the '.' and 'S' cells
+    static const PathResult& Dijkstra(const GridGraph& grid, int start, int end, SearchBuffers& buffers);
+
+    // Reference Dijkstra scanning every unvisited vertex for the minimum, O(V²), cross-checks Dijkstra in check/SolverCheck.cpp
+    static PathResult DijkstraLinearScan(Graph &graph, int start, int end, int rows, SolverStats* stats = nullptr);
+
+    // A* algorithm for finding the optimal path in the labyrinth, empty when the end cannot be reached
+    static PathResult AStar(Graph& graph, int start, int end, int rows, int numberV, SolverStats* stats = nullptr);
+
+    // A* algorithm on a compact grid, the path is stored in buffers.path until the next search, empty when the end cannot be reached
+    // On terrain grids the open cells are kept in Dial's buckets by their integer estimate instead of a heap
+    static const PathResult& AStar(const GridGraph& grid, int start, int end, SearchBuffers& buffers);
+
+    // Breadth-first search on a compact grid with unit costs and 4-neighbour moves, same path lengths as AStar
+    // without heap nor floating point, through GridSolver<FourConnected, UnitCost>
+    // The path is stored in buffers.path; grids with explicit edges, possibly weighted, are searched by AStar
+    static const PathResult& BreadthFirstSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers);
+
+    // Jump Point Search on a compact grid with unit costs and 4-neighbour moves, same path lengths as AStar
+    // Straight runs are scanned without being queued, only the cells where an optimal path may turn are expanded
+    // The path, every cell included, is stored in buffers.path; grids with explicit edges are searched by AStar
+    static const PathResult& JumpPointSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers);
+
+    // Bidirectional breadth-first search on a compact grid with unit costs, same path lengths as AStar
+    // One level is expanded at a time from the smaller side, the first cell reached by both sides lies on a shortest path
+    // The path is stored in buffers.path; grids with explicit edges, possibly one-way or weighted, are searched by AStar
+    static const PathResult& BidirectionalSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers);
+
+    // Hierarchical search (HPA*) on a compact grid with unit costs and 4-neighbour moves over buffers.hierarchy,
+    // which is built on first use and must then follow the grid: build it again for another grid, update it when cells change.
+    // Paths only cross the cluster borders at their entrances, so they may be a little longer than those of AStar.
+    // The path is stored in buffers.path; grids with explicit edges are searched by AStar
+    static const PathResult& HierarchicalSearch(const GridGraph& grid, int start, int end, SearchBuffers& buffers);
+
+    // Calculate the Manhattan distance between two points, admissible heuristic for 4-neighbour moves
+    static int manhattanDistance(int xa, int ya, int xb, int yb);
 
     // Calculate the Euclidean distance between two points
     static double distance(int xa, int ya, int xb, int yb);
 
     // Check if the prisoner can move to a specified vertex
     static bool canMove(int vertex_num, const std::vector<Vertex>& vertexList, int numberV);
+    static bool canMove(int vertex_num, const std::vector<char>& labels, int numberV);
 
     // Determine the movement direction for each turn in the labyrinth
     static std::vector<char> MovementDirectionForEachTurn(Graph& graph, int start, int end, int rows, int numberV);
+    static std::vector<char> MovementDirectionForEachTurn(const GridGraph& grid, int start, int end, SearchBuffers& buffers,
+                                                          PathSearch search = PathSearch::AStar);
 
     // Move the prisoner based on the given direction
     static bool movePrisoner(char possibleMovementDirectionForThisTurn, std::vector<Vertex> &vertexList, int lines, int rows);
+    static bool movePrisoner(char possibleMovementDirectionForThisTurn, std::vector<char> &labels, int lines, int rows);
 
     // Check if the prisoner reaches the exit and wins the game
     static bool winMove(int start, const std::vector<Vertex>& vertexList, int lines, int rows);
+    static bool winMove(int start, const std::vector<char>& labels, int lines, int rows);
 
     // Simulate the propagation of fire around a given vertex
     static bool firePropagationAround(int vertexNum, std::vector<Vertex>& vertexList, int lines, int rows);
+    static bool firePropagationAround(int vertexNum, std::vector<char>& labels, int lines, int rows);
+
+    // Convert a path given as vertex numbers into movement directions
+    static std::vector<char> movementDirections(const std::vector<int>& path, int rows);
 
     // Run an instance of the labyrinth game and return the result (Y for win, N for loss)
-    static char runInstance(Graph graph, int start, int end, int lines, int rows);
+    // The turn by turn simulation is the reference for escapeDecision, the grid is never written.
+    // It does not play terrain: every move and every spread of the fire take one turn, escapeDecision decides terrain
+    static char runInstance(Graph& graph, int start, int end, int lines, int rows);
+    static char runInstance(const GridGraph& grid, int start, int end, SearchBuffers& buffers,
+                            FireKernel kernel = FireKernel::Fronts, PathSearch search = PathSearch::AStar);
+
+    // Play the game turn by turn with a plan repaired after every spread of the fire instead of a route fixed up front
+    // The fire spreads from the cells it reached on the previous turn and the planner only sees the cells that closed,
+    // so a turn costs about the size of the burning front and of the repaired region. The labels kernel is always used
+    static char replanInstance(const GridGraph& grid, int start, int end, SearchBuffers& buffers);
+
+    // Simulate the given moves turn by turn and return the result (Y for win, N for loss)
+    static char replayInstance(const GridGraph& grid, const std::vector<char>& directions, SearchBuffers& buffers,
+                               FireKernel kernel = FireKernel::Fronts);
+
+    // Fill buffers.ignition with the turn at which each cell catches fire, breadth-first from every 'F' cell
+    // On terrain a cell ignites its fire delay after its first burning neighbour, the cells leave a bucket queue of Dial
+    static void fireArrivalTimes(const GridGraph& grid, SearchBuffers& buffers);
+
+    // Decide in linear time if the prisoner escapes (Y) or not (N) with the same rules as runInstance
+    // The prisoner may stand on a cell at turn t only if it ignites after turn t + 1, and step on the exit before it ignites
+    // When route is given it receives the vertex numbers of a fastest safe escape, empty on N.
+    // On terrain, crossing a cell takes its cost in turns: the prisoner must leave a '.' cell, reached at turn t,
+    // before it ignites after turn t + 1, and reach the exit before it ignites; the search runs on a bucket queue of Dial
+    static char escapeDecision(const GridGraph& grid, int start, int end, SearchBuffers& buffers, std::vector<int>* route = nullptr);
+
+    // Fill buffers.backward with the latest turn at which a prisoner may stand on each cell and still reach one of the exits,
+    // -1 when no escape starts there, and buffers.next with the following cell of that escape. buffers.ignition must be filled
+    // One pass from every exit at once: a cell keeps the value of the first neighbour that reaches it,
+    // the cells being taken from buckets of decreasing latest turn.
+    // On terrain the latest turn is min(ignition - 2, latest of a neighbour - its cost) and the cells leave a radix heap
+    static void exitDeadlines(const GridGraph& grid, SearchBuffers& buffers);
+
+    // Decide for every prisoner ('D' cell, in vertex number order) if they reach one of the exits ('S' cells) with the rules
+    // of escapeDecision, in two linear passes whatever the number of prisoners: the fire from every 'F' cell, then exitDeadlines.
+    // results receives one 'Y' or 'N' per prisoner, routes when given one escape per prisoner, empty on N.
+    // Prisoners do not block each other. Grids with explicit edges are decided one prisoner at a time toward the first exit
+    static void escapeDecisions(const GridGraph& grid, SearchBuffers& buffers, std::string& results,
+                                std::vector<std::vector<int>>* routes = nullptr);
+
+    // fireArrivalTimes, escapeDecision and escapeDecisions on a grid with unit costs copied in tiled order, same answers.
+    // The buffers are indexed by the cells of the TiledGrid (TiledGrid::cellOf), the prisoner, the exit and the routes are
+    // row-major cell numbers. The searches are serial, the parallel engine is not used
+    static void fireArrivalTimes(const TiledGrid& grid, SearchBuffers& buffers);
+    static char escapeDecision(const TiledGrid& grid, int start, int end, SearchBuffers& buffers, std::vector<int>* route = nullptr);
+    static void escapeDecisions(const TiledGrid& grid, SearchBuffers& buffers, std::string& results,
+                                std::vector<std::vector<int>>* routes = nullptr);
+
+    // Decide an instance of the batch mode into results: escapeDecision toward end for a single prisoner and a single exit,
+    // which stops at the exit, escapeDecisions otherwise, so that every exit is reached.
+    // Wide grids (TiledGrid::suits) are decided on buffers.tiled unless the parallel engine searches them
+    static void decideInstance(const GridGraph& grid, long long prisoners, long long exits, int start, int end,
+                               SearchBuffers& buffers, std::string& results);
+
+    // Same decision as escapeDecision, the prisoner's search meets a search from the exit
+    // The exit side gives each cell the latest turn at which the prisoner may stand on it and still escape:
+    // ignition(S) - 1 on the exit, min(ignition - 2, latest of a neighbour - 1) elsewhere, expanded from the latest turn down.
+    // The prisoner escapes when a cell is reached no later than its latest turn. The route, when given, is safe but not always the fastest
+    // Grids with explicit edges or terrain are decided by escapeDecision
+    static char bidirectionalEscapeDecision(const GridGraph& grid, int start, int end, SearchBuffers& buffers,
+                                            std::vector<int>* route = nullptr);
 };
 
 #endif //LABYRINTH_LABYRINTH_H
@@ -0,0 +1,383 @@
+#include "MazeCorpus.h" // Include the declaration of the MazeCorpus class
+#include "Terrain.h" // Include the costs of the terrain symbols
+#include <cstring> // Filling runs of labels
+#include <limits> // Largest grid of a GridGraph
+#include <fcntl.h> // Opening the corpus file
+#include <sys/mman.h> // Mapping the corpus file
+#include <sys/stat.h> // Size of the corpus file
+#include <unistd.h> // Closing the corpus file
+
+const uint32_t MazeCorpus::Magic;
+const uint32_t MazeCorpus::Version;
+const char MazeCorpus::symbols[] = ".#~=%23456789";
+const int MazeCorpus::SymbolCount;
+
+namespace {
+    // Round a size up to a multiple of 8 bytes
+    uint64_t aligned(uint64_t size) {
+        return (size + 7) & ~static_cast<uint64_t>(7);
+    }
+
+    // Code of the terrain of a free cell, the first symbol with its cost and fire delay, -1 when none has them
+    int terrainCode(int cost, int delay) {
+        for (int code = 0; code < MazeCorpus::SymbolCount; code++) {
+            int symbolCost = 0, symbolDelay = 0;
+            if (Terrain::lookup(MazeCorpus::symbols[code], symbolCost, symbolDelay)
+                && symbolCost == cost && symbolDelay == delay)
+                return code;
+        }
+        return -1;
+    }
+}
+
+bool MazeCorpus::Instance::unpack(WeightedGraph::GridGraph& grid, std::string& error) const {
+    // Vertex numbers of a GridGraph are int
+    long long numberV = size();
+    if (header->lines == 0 || header->rows == 0 || numberV > std::numeric_limits<int>::max()) {
+        error = "invalid dimensions " + std::to_string(header->lines) + " x " + std::to_string(header->rows) + ".";
+        return false;
+    }
+    if (header->prisoners == 0 || header->fires == 0 || header->exits == 0) {
+        error = "the instance must have at least one 'D', one 'F' and one 'S'.";
+        return false;
+    }
+    grid.reset(static_cast<int>(header->lines), static_cast<int>(header->rows));
+    char* labels = grid.labels.data();
+    int largestCode = header->terrain != 0 ? SymbolCount - 1 : 1;
+
+    // Walls and terrain, the free cells are already '.'
+    if (header->encoding == WallBits || header->encoding == TerrainCodes) {
+        if (header->encoding == WallBits) {
+            // Each byte of walls becomes 8 labels at once, the last byte may cover fewer cells
+            static const std::vector<uint64_t> expanded = [] {
+                std::vector<uint64_t> table(256);
+                for (int byte = 0; byte < 256; byte++) {
+                    char lanes[8];
+                    for (int bit = 0; bit < 8; bit++)
+                        lanes[bit] = (byte >> bit) & 1 ? '#' : '.';
+                    std::memcpy(&table[byte], lanes, 8);
+                }
+                return table;
+            }();
+            long long fullBytes = numberV / 8;
+            for (long long byte = 0; byte < fullBytes; byte++)
+                if (cells[byte] != 0)
+                    std::memcpy(labels + byte * 8, &expanded[cells[byte]], 8);
+            for (long long cell = fullBytes * 8; cell < numberV; cell++)
+                if ((cells[fullBytes] >> (cell & 7)) & 1)
+                    labels[cell] = '#';
+        } else {
+            for (long long cell = 0; cell < numberV; cell++) {
+                int value = code(cell);
+                if (value > largestCode) {
+                    error = "invalid cell code " + std::to_string(value) + ".";
+                    return false;
+                }
+                if (value != 0)
+                    grid.setCell(static_cast<int>(cell), symbols[value]);
+            }
+        }
+    } else if (header->encoding == Runs) {
+        uint64_t position = 0;
+        long long cell = 0;
+        while (cell < numberV) {
+            // A code byte, then the length on 7 bits per byte, lowest bits first
+            if (position >= header->cellBytes) {
+                error = "the runs end before the last cell.";
+                return false;
+            }
+            int value = cells[position++];
+            uint64_t run = 0;
+            int shift = 0;
+            while (true) {
+                if (position >= header->cellBytes || shift > 56) {
+                    error = "truncated run length.";
+                    return false;
+                }
+                uint8_t byte = cells[position++];
+                run |= static_cast<uint64_t>(byte & 127) << shift;
+                shift += 7;
+                if (!(byte & 128))
+                    break;
+            }
+            if (value > largestCode || run == 0 || run > static_cast<uint64_t>(numberV - cell)) {
+                error = "invalid run of " + std::to_string(run) + " cells of code " + std::to_string(value) + ".";
+                return false;
+            }
+            if (value == 1)
+                std::memset(labels + cell, '#', static_cast<size_t>(run));
+            else if (value != 0)
+                for (long long k = cell; k < cell + static_cast<long long>(run); k++)
+                    grid.setCell(static_cast<int>(k), symbols[value]);
+            cell += static_cast<long long>(run);
+        }
+        if (position != header->cellBytes) {
+            error = "bytes left after the last run.";
+            return false;
+        }
+    } else {
+        error = "unknown encoding " + std::to_string(header->encoding) + ".";
+        return false;
+    }
+
+    // Prisoners, fires and exits, each on a cell of the grid that is not a wall
+    struct List {
+        const uint32_t* cells;
+        uint32_t count;
+        char label;
+    };
+    const List lists[] = {{prisoners, header->prisoners, 'D'}, {fires, header->fires, 'F'}, {exits, header->exits, 'S'}};
+    for (const List& list : lists) {
+        for (uint32_t k = 0; k < list.count; k++) {
+            uint32_t cell = list.cells[k];
+            if (cell >= numberV || labels[cell] == '#') {
+                error = "the '" + std::string(1, list.label) + "' cell " + std::to_string(cell) + " is outside the grid or a wall.";
+                return false;
+            }
+            labels[cell] = list.label;
+        }
+    }
+    return true;
+}
+
+MazeCorpus::~MazeCorpus() {
+    close();
+}
+
+bool MazeCorpus::open(const std::string& file, std::string& error) {
+    close();
+    int fd = ::open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + file + ".";
+        return false;
+    }
+    struct stat status{};
+    if (fstat(fd, &status) != 0 || status.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(fd);
+        error = file + " is too short for a corpus.";
+        return false;
+    }
+    length = static_cast<size_t>(status.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        length = 0;
+        error = "cannot map " + file + ".";
+        return false;
+    }
+    data = static_cast<const uint8_t*>(mapping);
+
+    // Check the header and that the index lies inside the file
+    const Header* header = reinterpret_cast<const Header*>(data);
+    if (header->magic != Magic) {
+        bool swapped = header->magic == ((Magic >> 24) | ((Magic >> 8) & 0xff00) | ((Magic << 8) & 0xff0000) | (Magic << 24));
+        close();
+        error = file + (swapped ? " was written on a machine of the other byte order." : " is not a corpus.");
+        return false;
+    }
+    if (header->version != Version) {
+        uint32_t version = header->version;
+        close();
+        error = file + " has version " + std::to_string(version) + ", expected " + std::to_string(Version) + ".";
+        return false;
+    }
+    if (header->indexOffset % 8 != 0 || header->indexOffset > length
+        || header->instances > (length - header->indexOffset) / sizeof(uint64_t)) {
+        close();
+        error = file + " has an index outside the file.";
+        return false;
+    }
+    index = reinterpret_cast<const uint64_t*>(data + header->indexOffset);
+    count = header->instances;
+    return true;
+}
+
+void MazeCorpus::close() {
+    if (data != nullptr)
+        munmap(const_cast<uint8_t*>(data), length);
+    data = nullptr;
+    length = 0;
+    index = nullptr;
+    count = 0;
+}
+
+bool MazeCorpus::instance(uint64_t k, Instance& view, std::string& error) const {
+    // Every part of the record must lie inside the file
+    if (k >= count) {
+        error = "the corpus holds " + std::to_string(count) + " instances.";
+        return false;
+    }
+    uint64_t offset = index[k];
+    if (offset % 8 != 0 || offset > length || length - offset < sizeof(RecordHeader)) {
+        error = "record outside the file.";
+        return false;
+    }
+    const RecordHeader* header = reinterpret_cast<const RecordHeader*>(data + offset);
+    uint64_t cellCount = static_cast<uint64_t>(header->lines) * header->rows;
+    uint64_t listBytes = aligned(4 * (static_cast<uint64_t>(header->prisoners) + header->fires + header->exits));
+    uint64_t answerBytes = aligned(header->answerLength);
+    uint64_t expected = header->terrain != 0 ? (cellCount + 1) / 2 : (cellCount + 7) / 8;
+    if ((header->encoding != Runs && header->cellBytes != expected)
+        || header->cellBytes > length || listBytes + answerBytes + header->cellBytes > length - offset - sizeof(RecordHeader)) {
+        error = "record larger than the file.";
+        return false;
+    }
+    if (header->answerLength != 0 && header->answerLength != header->prisoners) {
+        error = "the stored answer does not have one character per prisoner.";
+        return false;
+    }
+
+    const uint8_t* position = data + offset + sizeof(RecordHeader);
+    view.header = header;
+    view.prisoners = reinterpret_cast<const uint32_t*>(position);
+    view.fires = view.prisoners + header->prisoners;
+    view.exits = view.fires + header->fires;
+    position += listBytes;
+    view.answer = header->answerLength != 0 ? reinterpret_cast<const char*>(position) : nullptr;
+    position += answerBytes;
+    view.cells = position;
+    return true;
+}
+
+MazeCorpusWriter::~MazeCorpusWriter() {
+    if (file != nullptr)
+        std::fclose(file);
+}
+
+bool MazeCorpusWriter::open(const std::string& name, std::string& error) {
+    // The header is written again by finish, once the index is known
+    file = std::fopen(name.c_str(), "wb");
+    if (file == nullptr) {
+        error = "cannot create " + name + ".";
+        return false;
+    }
+    position = 0;
+    offsets.clear();
+    MazeCorpus::Header header{};
+    if (!write(&header, sizeof(header))) {
+        error = "cannot write " + name + ".";
+        return false;
+    }
+    return true;
+}
+
+bool MazeCorpusWriter::write(const void* bytes, size_t size) {
+    if (size != 0 && std::fwrite(bytes, 1, size, file) != size)
+        return false;
+    position += size;
+    return true;
+}
+
+bool MazeCorpusWriter::pad() {
+    static const uint8_t zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    return write(zeros, static_cast<size_t>(aligned(position) - position));
+}
+
+bool MazeCorpusWriter::add(const WeightedGraph::GridGraph& grid, const std::string* answer, bool runLength, std::string& error) {
+    std::string where = "instance " + std::to_string(offsets.size() + 1) + " : ";
+    long long numberV = grid.size();
+    bool terrain = grid.weighted();
+
+    // Cells of the prisoners, fires and exits, grouped in this order
+    cellLists.clear();
+    uint32_t counts[3] = {0, 0, 0};
+    const char kinds[3] = {'D', 'F', 'S'};
+    for (int kind = 0; kind < 3; kind++) {
+        for (long long v = 0; v < numberV; v++) {
+            if (grid.labels[v] == kinds[kind]) {
+                cellLists.push_back(static_cast<uint32_t>(v));
+                counts[kind]++;
+            }
+        }
+    }
+    if (answer != nullptr && answer->size() != counts[0]) {
+        error = where + "the answer does not have one character per prisoner.";
+        return false;
+    }
+
+    // Packed codes, and runs of equal codes when asked
+    packed.assign(terrain ? static_cast<size_t>((numberV + 1) / 2) : static_cast<size_t>((numberV + 7) / 8), 0);
+    runs.clear();
+    int runCode = -1;
+    uint64_t runLengthSoFar = 0;
+    auto flush = [&]() {
+        runs.push_back(static_cast<uint8_t>(runCode));
+        for (uint64_t rest = runLengthSoFar; ; rest >>= 7) {
+            if (rest < 128) {
+                runs.push_back(static_cast<uint8_t>(rest));
+                break;
+            }
+            runs.push_back(static_cast<uint8_t>((rest & 127) | 128));
+        }
+    };
+    for (long long v = 0; v < numberV; v++) {
+        char label = grid.labels[v];
+        int code = 0;
+        if (label == '#') {
+            code = 1;
+        } else if (label == '.' && terrain) {
+            code = terrainCode(grid.costs[v], grid.fireDelays[v]);
+        } else if (label != '.' && label != 'D' && label != 'F' && label != 'S') {
+            code = -1;
+        }
+        if (code < 0) {
+            error = where + "the cell '" + std::string(1, label) + "' cannot be stored.";
+            return false;
+        }
+        if (terrain)
+            packed[static_cast<size_t>(v >> 1)] |= static_cast<uint8_t>(code << ((v & 1) * 4));
+        else
+            packed[static_cast<size_t>(v >> 3)] |= static_cast<uint8_t>(code << (v & 7));
+        if (runLength) {
+            if (code != runCode && runCode != -1) {
+                flush();
+                runLengthSoFar = 0;
+            }
+            runCode = code;
+            runLengthSoFar++;
+        }
+    }
+    if (runLength && runCode != -1)
+        flush();
+    bool useRuns = runLength && runs.size() < packed.size();
+    const std::vector<uint8_t>& cells = useRuns ? runs : packed;
+
+    // Record header, lists, answer and cells, each padded to 8 bytes
+    MazeCorpus::RecordHeader header{};
+    header.lines = static_cast<uint32_t>(grid.lines);
+    header.rows = static_cast<uint32_t>(grid.rows);
+    header.encoding = useRuns ? MazeCorpus::Runs : terrain ? MazeCorpus::TerrainCodes : MazeCorpus::WallBits;
+    header.prisoners = counts[0];
+    header.fires = counts[1];
+    header.exits = counts[2];
+    header.answerLength = answer != nullptr ? static_cast<uint32_t>(answer->size()) : 0;
+    header.terrain = terrain ? 1 : 0;
+    header.cellBytes = cells.size();
+    offsets.push_back(position);
+    bool written = write(&header, sizeof(header)) && write(cellLists.data(), cellLists.size() * sizeof(uint32_t)) && pad()
+                   && (answer == nullptr || write(answer->data(), answer->size())) && pad()
+                   && write(cells.data(), cells.size()) && pad();
+    if (!written) {
+        error = where + "cannot write the record.";
+        return false;
+    }
+    return true;
+}
+
+bool MazeCorpusWriter::finish(std::string& error) {
+    // The index follows the last record, the header points to it
+    MazeCorpus::Header header{};
+    header.magic = MazeCorpus::Magic;
+    header.version = MazeCorpus::Version;
+    header.instances = offsets.size();
+    header.indexOffset = position;
+    bool written = write(offsets.data(), offsets.size() * sizeof(uint64_t)) && std::fseek(file, 0, SEEK_SET) == 0
+                   && std::fwrite(&header, sizeof(header), 1, file) == 1;
+    written = std::fclose(file) == 0 && written;
+    file = nullptr;
+    if (!written) {
+        error = "cannot write the index of the corpus.";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,142 @@
+#ifndef LABYRINTH_MAZECORPUS_H
+#define LABYRINTH_MAZECORPUS_H
+
+#include "WeightedGraph.h" // Include the declaration of the WeightedGraph class
+#include <cstddef> // Size types
+#include <cstdint> // Fixed width integers
+#include <cstdio> // Output file of the writer
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+
+// Binary container of many instances, written once by MazeCorpusWriter and read in place through a memory mapping
+// Layout, in the byte order of the host (little-endian on the supported machines), every part 8-byte aligned:
+//   Header   magic "LBYC", version, instance count, offset of the index
+//   Records  one per instance: a RecordHeader, the cell numbers of the prisoners, fires and exits (uint32, increasing),
+//            the expected answer when stored (one 'Y' or 'N' per prisoner), then the cells
+//   Index    offset of every record (uint64), so instance k is reached without reading the others
+// The cells hold walls and terrain only, the D, F and S cells are stored as '.' and listed in their arrays.
+// Walls take 1 bit per cell, grids with terrain 4 bits per cell (a code of MazeCorpus::symbols).
+// A run-length encoded grid replaces these bits by runs: a code byte and the run length as a base-128 varint
+class MazeCorpus {
+public:
+    // Magic number ("LBYC") and version of the format
+    static const uint32_t Magic = 0x4359424c;
+    static const uint32_t Version = 1;
+
+    // Encodings of the cells
+    enum Encoding : uint32_t {
+        WallBits = 0, // 1 bit per cell, set for the walls
+        TerrainCodes = 1, // 4 bits per cell, the code of the cell's symbol
+        Runs = 2 // Runs of equal codes
+    };
+
+    // Symbol of each 4-bit code, the terrain of WeightedGraph::GridGraph::setCell
+    static const char symbols[];
+    static const int SymbolCount = 13;
+
+    // Fixed part of a file
+    struct Header {
+        uint32_t magic; // Magic
+        uint32_t version; // Version
+        uint64_t instances; // Number of instances
+        uint64_t indexOffset; // Offset of the index from the start of the file
+    };
+
+    // Fixed part of a record
+    struct RecordHeader {
+        uint32_t lines; // Number of lines of the grid
+        uint32_t rows; // Number of cells per line
+        uint32_t encoding; // Encoding of the cells
+        uint32_t prisoners; // Number of 'D' cells
+        uint32_t fires; // Number of 'F' cells
+        uint32_t exits; // Number of 'S' cells
+        uint32_t answerLength; // Length of the stored answer, 0 when none is stored
+        uint32_t terrain; // 1 when the codes are 4-bit terrain codes, 0 for wall bits
+        uint64_t cellBytes; // Size of the cells
+    };
+
+    // View of one instance inside the mapping, valid while the corpus stays open
+    // The arrays and the cells are read in place, nothing is copied
+    struct Instance {
+        const RecordHeader* header = nullptr; // Fixed part of the record
+        const uint32_t* prisoners = nullptr; // Cells of the prisoners, increasing
+        const uint32_t* fires = nullptr; // Cells of the fires, increasing
+        const uint32_t* exits = nullptr; // Cells of the exits, increasing
+        const char* answer = nullptr; // Stored answer, null when none is stored
+        const uint8_t* cells = nullptr; // Encoded cells
+
+        // Number of cells of the grid
+        long long size() const {
+            return static_cast<long long>(header->lines) * header->rows;
+        }
+
+        // Code of a cell, only for grids that are not run-length encoded
+        int code(long long cell) const {
+            if (header->terrain == 0)
+                return (cells[cell >> 3] >> (cell & 7)) & 1;
+            return (cells[cell >> 1] >> ((cell & 1) * 4)) & 15;
+        }
+
+        // Fill a grid with the instance, reusing its memory: labels, terrain costs, prisoners, fires and exits
+        // Return false and describe the problem in error when the record is malformed
+        bool unpack(WeightedGraph::GridGraph& grid, std::string& error) const;
+    };
+
+    MazeCorpus() = default;
+    MazeCorpus(const MazeCorpus&) = delete;
+    MazeCorpus& operator=(const MazeCorpus&) = delete;
+    ~MazeCorpus();
+
+    // Map a corpus file and check its header and its index, return false with a message on failure
+    bool open(const std::string& file, std::string& error);
+
+    // Unmap the file, the views given before become invalid
+    void close();
+
+    // Number of instances
+    uint64_t size() const {
+        return count;
+    }
+
+    // View of instance k (from 0), return false with a message when its record does not fit in the file
+    bool instance(uint64_t k, Instance& view, std::string& error) const;
+
+private:
+    const uint8_t* data = nullptr; // Mapped file
+    size_t length = 0; // Size of the file
+    const uint64_t* index = nullptr; // Offset of each record
+    uint64_t count = 0; // Number of instances
+};
+
+// Writer of a corpus file: records are appended one by one, the index and the header are written by finish
+class MazeCorpusWriter {
+public:
+    MazeCorpusWriter() = default;
+    MazeCorpusWriter(const MazeCorpusWriter&) = delete;
+    MazeCorpusWriter& operator=(const MazeCorpusWriter&) = delete;
+    ~MazeCorpusWriter();
+
+    // Create the file, return false with a message on failure
+    bool open(const std::string& file, std::string& error);
+
+    // Append an instance, answer is stored when not null. With runLength the cells are stored as runs when it is smaller
+    // Labels other than '.', '#', 'D', 'F' and 'S' with the terrain of the grid cannot be stored
+    bool add(const WeightedGraph::GridGraph& grid, const std::string* answer, bool runLength, std::string& error);
+
+    // Write the index and the header and close the file
+    bool finish(std::string& error);
+
+private:
+    FILE* file = nullptr; // Output file
+    uint64_t position = 0; // Bytes written so far
+    std::vector<uint64_t> offsets; // Offset of each record
+    std::vector<uint32_t> cellLists; // Cells of the prisoners, fires and exits of the record being written
+    std::vector<uint8_t> packed; // Bit or nibble packed cells of the record being written
+    std::vector<uint8_t> runs; // Run-length encoded cells of the record being written
+
+    // Write bytes and pad the file to a multiple of 8 bytes
+    bool write(const void* bytes, size_t size);
+    bool pad();
+};
+
+#endif //LABYRINTH_MAZECORPUS_H
@@ -0,0 +1,173 @@
+#include "PackedGrid.h" // Include the declaration of the PackedGrid class
+#include <algorithm> // Include the algorithm header for std::reverse
+#include <limits> // Include the limits header for numeric limits
+
+const long long PackedGrid::MinimumCells;
+const int PackedGrid::ExitMark;
+
+namespace {
+    // Call visit(neighbor, direction) for the 4 neighbours of a cell
+    // Directions: 0 from the cell above, 1 from the left, 2 from the right, 3 from the cell below
+    template <typename Index, typename Visit>
+    void forEachNeighbor(Index cell, long long lines, long long rows, Visit visit) {
+        long long j = static_cast<long long>(cell) % rows;
+        if (static_cast<long long>(cell) >= rows)
+            visit(static_cast<Index>(cell - rows), 3); // Entered from below
+        if (j != 0)
+            visit(static_cast<Index>(cell - 1), 2); // Entered from the right
+        if (j != rows - 1)
+            visit(static_cast<Index>(cell + 1), 1); // Entered from the left
+        if (static_cast<long long>(cell) + rows < lines * rows)
+            visit(static_cast<Index>(cell + rows), 0); // Entered from above
+    }
+}
+
+void PackedGrid::reset(long long lines, long long rows) {
+    // Every cell open, the memory of the previous grid is reused
+    this->lines = lines;
+    this->rows = rows;
+    start = -1;
+    exits = 0;
+    fires.clear();
+    cells.assign(static_cast<size_t>((lines * rows + 1) / 2), 0);
+}
+
+bool PackedGrid::setLabel(long long cell, char label) {
+    // Translate a label of the input into a state or a position
+    switch (label) {
+        case '.':
+            return true;
+        case '#':
+            setState(cell, Wall);
+            return true;
+        case 'D':
+            start = cell;
+            return true;
+        case 'S':
+            setDirection(cell, ExitMark);
+            exits++;
+            return true;
+        case 'F':
+            setState(cell, Burned);
+            fires.push_back(cell);
+            return true;
+        default:
+            return false;
+    }
+}
+
+char PackedGrid::escapeDecision(std::vector<long long>* route, SolverStats* stats) {
+    // 32-bit frontiers halve their memory whenever every cell number fits
+    PhaseTimer timer(stats != nullptr ? &stats->searchNanoseconds : nullptr);
+    if (size() <= static_cast<long long>(std::numeric_limits<uint32_t>::max()))
+        return decide<uint32_t>(route, stats);
+    return decide<uint64_t>(route, stats);
+}
+
+template <typename Index>
+char PackedGrid::decide(std::vector<long long>* route, SolverStats* stats) {
+    if (route != nullptr)
+        route->clear();
+    long long expanded = 0, relaxed = 0, pushes = 0, peak = 0;
+
+    std::vector<Index> fire(fires.begin(), fires.end()), nextFire;
+    std::vector<Index> prisoner, nextPrisoner;
+    std::vector<Index> exitsBurning; // Exits reached by the last spread of the fire, still free for one more turn
+
+    // Spread the fire by one level. An exit reached by this spread is stored as a wall with ExitMark, which the fire
+    // skips like a burned cell and the prisoner recognises in constant time; the next spread makes it a burned cell
+    auto spread = [&]() {
+        for (Index cell : exitsBurning)
+            setState(cell, Burned);
+        nextFire.clear();
+        exitsBurning.clear();
+        expanded += static_cast<long long>(fire.size());
+        for (Index cell : fire) {
+            forEachNeighbor(cell, lines, rows, [&](Index neighbor, int) {
+                relaxed++;
+                State current = state(neighbor);
+                if (current == Wall || current == Burned)
+                    return;
+                bool isExit = current == Open && direction(neighbor) == ExitMark;
+                if (isExit)
+                    exitsBurning.push_back(neighbor);
+                setState(neighbor, isExit ? Wall : Burned);
+                nextFire.push_back(neighbor);
+            });
+        }
+        fire.swap(nextFire);
+        pushes += static_cast<long long>(fire.size());
+        if (static_cast<long long>(fire.size()) > peak)
+            peak = static_cast<long long>(fire.size());
+    };
+
+    // Add the counters to the statistics once the decision is known
+    auto report = [&](char result) {
+        if (stats != nullptr) {
+            stats->verticesExpanded += expanded;
+            stats->edgesRelaxed += relaxed;
+            stats->heapPushes += pushes;
+            stats->heapPops += expanded;
+            if (peak > stats->peakOpenSet)
+                stats->peakOpenSet = peak;
+        }
+        return result;
+    };
+
+    // The fire spreads before the prisoner's first move, they must survive it
+    spread();
+    if (state(start) == Burned)
+        return report('N');
+    setState(start, Visited);
+    prisoner.push_back(static_cast<Index>(start));
+
+    // Turn t: the fire reaches its level t + 1 first, so the cells the prisoner enters at turn t
+    // are exactly those still unburned, and an exit must not have burned before turn t + 1
+    bool escaped = false;
+    long long exit = -1;
+    for (long long turn = 1; !prisoner.empty() && !escaped; turn++) {
+        spread();
+        nextPrisoner.clear();
+        for (Index cell : prisoner) {
+            expanded++;
+            forEachNeighbor(cell, lines, rows, [&](Index neighbor, int direction) {
+                if (escaped)
+                    return;
+                relaxed++;
+                State current = state(neighbor);
+                bool isExit = (current == Open || current == Wall) && this->direction(neighbor) == ExitMark;
+                if (isExit) {
+                    setDirection(neighbor, direction);
+                    exit = static_cast<long long>(neighbor);
+                    escaped = true;
+                } else if (current == Open) {
+                    setState(neighbor, Visited);
+                    setDirection(neighbor, direction);
+                    nextPrisoner.push_back(neighbor);
+                }
+            });
+            if (escaped)
+                break;
+        }
+        prisoner.swap(nextPrisoner);
+        pushes += static_cast<long long>(prisoner.size());
+        if (static_cast<long long>(prisoner.size()) > peak)
+            peak = static_cast<long long>(prisoner.size());
+    }
+
+    if (!escaped)
+        return report('N');
+
+    // Walk the direction bits back from the exit
+    if (route != nullptr) {
+        const long long offsets[4] = {-rows, -1, 1, rows}; // Position of the previous cell for each direction
+        long long cell = exit;
+        route->push_back(cell);
+        while (cell != start) {
+            cell += offsets[direction(cell)];
+            route->push_back(cell);
+        }
+        std::reverse(route->begin(), route->end());
+    }
+    return report('Y');
+}
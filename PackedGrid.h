@@ -0,0 +1,86 @@
+#ifndef LABYRINTH_PACKEDGRID_H
+#define LABYRINTH_PACKEDGRID_H
+
+#include <cstddef> // Size types
+#include <cstdint> // Fixed width integers
+#include <vector> // Dynamic array functionality using vectors
+#include "SolverStats.h" // Include the solver statistics
+
+// Packed grid for giant labyrinths: 4 bits per cell, two cells per byte
+// Bits 0-1 hold the state of the cell (open, wall, burned or visited by the prisoner),
+// bits 2-3 the direction of the move that brought the prisoner there, used to rebuild the route.
+// The prisoner (D) and the fires (F) are kept as cell numbers, not in the grid. The exits (S) are open or burned cells
+// whose direction bits hold ExitMark, the prisoner never enters them so the bits are free. During a decision, an exit
+// the fire reached in the last spread is a Wall with ExitMark: walls never carry a direction, so the mark is unambiguous.
+class PackedGrid {
+public:
+    // Grids with at least this many cells are read into a PackedGrid by the batch mode
+    static const long long MinimumCells = 1LL << 24;
+
+    // State of a cell
+    enum State {
+        Open = 0, // Free cell not reached by the prisoner yet
+        Wall = 1, // Wall ('#'), never burns
+        Burned = 2, // Cell reached by the fire
+        Visited = 3 // Cell reached by the prisoner ahead of the fire
+    };
+
+    long long lines = 0; // Number of lines of the grid
+    long long rows = 0; // Number of cells per line
+    long long start = -1; // Cell number of the prisoner
+    long long exits = 0; // Number of exits
+    std::vector<long long> fires; // Cell numbers of the fires
+
+    // Prepare a grid of lines * rows open cells, memory is kept between grids
+    void reset(long long lines, long long rows);
+
+    // Store a label ('.', '#', 'D', 'F' or 'S') in a cell, return false for any other label
+    // Several exits and fires are accepted, the last 'D' is the prisoner
+    bool setLabel(long long cell, char label);
+
+    // Number of cells of the grid
+    long long size() const {
+        return lines * rows;
+    }
+
+    // Direction bits of the exits
+    static const int ExitMark = 3;
+
+    // Access to the state and the direction bits of a cell
+    State state(long long cell) const {
+        return static_cast<State>(nibble(cell) & 3);
+    }
+    void setState(long long cell, State state) {
+        setNibble(cell, static_cast<uint8_t>((nibble(cell) & 12) | state));
+    }
+    int direction(long long cell) const {
+        return nibble(cell) >> 2;
+    }
+    void setDirection(long long cell, int direction) {
+        setNibble(cell, static_cast<uint8_t>((nibble(cell) & 3) | (direction << 2)));
+    }
+
+    // Decide if the prisoner reaches one of the exits with the rules of Labyrinth::escapeDecision, the fire and the prisoner
+    // are advanced together one level at a time so no distance or ignition array is needed
+    // The states of the cells are consumed, route receives the cell numbers of the escape when given
+    // stats receives the counters of both frontiers when given
+    char escapeDecision(std::vector<long long>* route = nullptr, SolverStats* stats = nullptr);
+
+private:
+    std::vector<uint8_t> cells; // Two cells per byte, even cells in the low nibble
+
+    uint8_t nibble(long long cell) const {
+        return (cells[static_cast<size_t>(cell >> 1)] >> ((cell & 1) << 2)) & 15;
+    }
+    void setNibble(long long cell, uint8_t value) {
+        uint8_t& byte = cells[static_cast<size_t>(cell >> 1)];
+        int shift = static_cast<int>((cell & 1) << 2);
+        byte = static_cast<uint8_t>((byte & ~(15 << shift)) | (value << shift));
+    }
+
+    // Lockstep search with frontiers of the smallest index type holding every cell number
+    template <typename Index>
+    char decide(std::vector<long long>* route, SolverStats* stats);
+};
+
+#endif //LABYRINTH_PACKEDGRID_H
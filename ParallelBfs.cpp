@@ -0,0 +1,208 @@
+#include "ParallelBfs.h" // Include the declaration of the ParallelBfs class
+
+namespace {
+    // Number of items a thread takes at once from a range
+    const long long ChunkSize = 1024;
+
+    // Levels with fewer cells are expanded by the calling thread alone
+    const size_t SerialLevel = 4096;
+
+    // Relaxed atomic accesses to the shared distance array
+    int loadDistance(const int* distance, int cell) {
+        return __atomic_load_n(&distance[cell], __ATOMIC_RELAXED);
+    }
+    bool claim(int* distance, int cell, int unvisited, int level) {
+        return __atomic_compare_exchange_n(&distance[cell], &unvisited, level, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+    }
+}
+
+const int ParallelBfs::MinimumCells;
+
+ParallelBfs::ParallelBfs(int threads)
+        : threads(threads < 1 ? 1 : threads), ranges(new Range[threads < 1 ? 1 : threads]),
+          localQueues(threads < 1 ? 1 : threads), reachedEnd(false) {}
+
+void ParallelBfs::fireArrivalTimes(const WeightedGraph::GridGraph& grid, std::vector<int>& ignition, int neverBurns) {
+    // Multi-source search from every burning cell
+    int numberV = grid.size();
+    ignition.assign(numberV, neverBurns);
+    std::vector<int> sources;
+    for (int v = 0; v < numberV; v++) {
+        if (grid.labels[v] == 'F') {
+            ignition[v] = 0;
+            sources.push_back(v);
+        }
+    }
+
+    Search fire = {&grid, nullptr, ignition.data(), nullptr, neverBurns, -1};
+    run(fire, sources);
+}
+
+bool ParallelBfs::prisonerArrivalTimes(const WeightedGraph::GridGraph& grid, int start, int end,
+                                       const std::vector<int>& ignition, std::vector<int>& arrival, std::vector<int>& prev) {
+    // Search from the prisoner through the cells reached strictly before the fire
+    int numberV = grid.size();
+    arrival.assign(numberV, -1);
+    prev.assign(numberV, -1);
+    arrival[start] = 0;
+
+    Search prisoner = {&grid, ignition.data(), arrival.data(), prev.data(), -1, end};
+    return run(prisoner, std::vector<int>(1, start));
+}
+
+bool ParallelBfs::canEnter(int cell, int nextLevel) const {
+    char label = search.grid->labels[cell];
+    if (search.end < 0)
+        return label != '#'; // Fire: walls never burn
+    if (cell == search.end)
+        return search.ignition[cell] > nextLevel; // The exit must still be free when the prisoner steps on it
+    return label == '.' && search.ignition[cell] > nextLevel + 1; // The cell must survive the next spread
+}
+
+bool ParallelBfs::run(const Search& newSearch, const std::vector<int>& sources) {
+    search = newSearch;
+    level = 0;
+    reachedEnd = false;
+    frontier = sources;
+    nextFrontier.clear();
+    long long numberV = search.grid->size();
+
+    // Start the helpers, they wait for the first parallel level
+    stopping = false;
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < threads; t++)
+        helpers.emplace_back(&ParallelBfs::help, this, t, generation);
+
+    while (!frontier.empty() && !reachedEnd) {
+        // Large frontiers are cheaper to expand from the unvisited side
+        if (!bottomUp && static_cast<long long>(frontier.size()) > numberV / 64)
+            bottomUp = true;
+        else if (bottomUp && static_cast<long long>(frontier.size()) < numberV / 256)
+            bottomUp = false;
+
+        if (!bottomUp && (frontier.size() < SerialLevel || threads == 1)) {
+            // Small level: expand it on this thread only
+            expandTopDown(0, static_cast<long long>(frontier.size()), nextFrontier);
+        } else {
+            // Split the work evenly, the threads steal from each other once their share is done
+            long long items = bottomUp ? numberV : static_cast<long long>(frontier.size());
+            for (int t = 0; t < threads; t++) {
+                ranges[t].next = items * t / threads;
+                ranges[t].end = items * (t + 1) / threads;
+                localQueues[t].clear();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                generation++;
+                running = threads - 1;
+            }
+            phaseStarted.notify_all();
+            expand(0);
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                phaseDone.wait(lock, [this] { return running == 0; });
+            }
+
+            // Gather the cells discovered by every thread
+            for (int t = 0; t < threads; t++)
+                nextFrontier.insert(nextFrontier.end(), localQueues[t].begin(), localQueues[t].end());
+        }
+
+        frontier.swap(nextFrontier);
+        nextFrontier.clear();
+        level++;
+    }
+
+    // Release the helpers
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    phaseStarted.notify_all();
+    for (std::thread& helper : helpers)
+        helper.join();
+    bottomUp = false;
+    return reachedEnd;
+}
+
+void ParallelBfs::help(int thread, long long started) {
+    // Wait for each parallel level and take part in it
+    long long seen = started;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            phaseStarted.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+        expand(thread);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running--;
+        }
+        phaseDone.notify_one();
+    }
+}
+
+void ParallelBfs::expand(int thread) {
+    // Own share first, then chunks stolen from the other threads
+    std::vector<int>& queue = localQueues[thread];
+    for (int k = 0; k < threads; k++) {
+        Range& range = ranges[(thread + k) % threads];
+        while (true) {
+            long long first = range.next.fetch_add(ChunkSize);
+            if (first >= range.end)
+                break;
+            long long last = first + ChunkSize < range.end ? first + ChunkSize : range.end;
+            if (bottomUp)
+                expandBottomUp(first, last, queue);
+            else
+                expandTopDown(first, last, queue);
+        }
+    }
+}
+
+void ParallelBfs::expandTopDown(long long first, long long last, std::vector<int>& queue) {
+    // Claim the unvisited neighbours of the frontier cells, the first thread to claim a cell owns it
+    int next = level + 1;
+    for (long long k = first; k < last; k++) {
+        int v = frontier[static_cast<size_t>(k)];
+        search.grid->forEachNeighbor(v, [&](int neighbor, double) {
+            if (loadDistance(search.distance, neighbor) != search.unvisited || !canEnter(neighbor, next))
+                return;
+            if (!claim(search.distance, neighbor, search.unvisited, next))
+                return;
+            if (search.prev != nullptr)
+                search.prev[neighbor] = v;
+            if (neighbor == search.end)
+                reachedEnd = true;
+            else
+                queue.push_back(neighbor);
+        });
+    }
+}
+
+void ParallelBfs::expandBottomUp(long long first, long long last, std::vector<int>& queue) {
+    // Each unvisited cell looks for a neighbour on the current level, only its thread writes it
+    int next = level + 1;
+    for (long long k = first; k < last; k++) {
+        int v = static_cast<int>(k);
+        if (loadDistance(search.distance, v) != search.unvisited || !canEnter(v, next))
+            continue;
+        int parent = -1;
+        search.grid->forEachNeighbor(v, [&](int neighbor, double) {
+            if (parent < 0 && loadDistance(search.distance, neighbor) == level)
+                parent = neighbor;
+        });
+        if (parent < 0)
+            continue;
+        __atomic_store_n(&search.distance[v], next, __ATOMIC_RELAXED);
+        if (search.prev != nullptr)
+            search.prev[v] = parent;
+        if (v == search.end)
+            reachedEnd = true;
+        else
+            queue.push_back(v);
+    }
+}
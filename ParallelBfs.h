@@ -0,0 +1,91 @@
+#ifndef LABYRINTH_PARALLELBFS_H
+#define LABYRINTH_PARALLELBFS_H
+
+#include "WeightedGraph.h" // Include the declaration of the WeightedGraph class
+#include <atomic> // Shared chunk counters
+#include <condition_variable> // Starting and joining the level phases
+#include <memory> // Owning arrays of non-movable ranges
+#include <mutex> // Protection of the phase counters
+#include <thread> // Helper threads
+#include <vector> // Dynamic array functionality using vectors
+
+// Level-synchronous breadth-first search of one large grid on several threads
+// Each level is expanded top-down from the frontier while it is small and bottom-up from the unvisited cells
+// once it becomes large. Threads write to local queues and steal chunks of work from each other.
+// Distances are exactly those of the serial searches in Labyrinth, only the choice among equal predecessors may differ.
+class ParallelBfs {
+public:
+    // Grids smaller than this are searched serially by Labyrinth
+    static const int MinimumCells = 1 << 16;
+
+    // Engine using the given number of threads, the calling thread included
+    explicit ParallelBfs(int threads);
+
+    // Number of threads used by the searches
+    int threadCount() const {
+        return threads;
+    }
+
+    // Ignition turn of every cell from the 'F' cells, walls never burn, unreached cells get neverBurns
+    void fireArrivalTimes(const WeightedGraph::GridGraph& grid, std::vector<int>& ignition, int neverBurns);
+
+    // Earliest turn at which the prisoner reaches each cell ahead of the fire, -1 when not reached
+    // Same rules as Labyrinth::escapeDecision, return true if the exit is reached
+    bool prisonerArrivalTimes(const WeightedGraph::GridGraph& grid, int start, int end, const std::vector<int>& ignition,
+                              std::vector<int>& arrival, std::vector<int>& prev);
+
+private:
+    // Half-open range of work items shared by the threads, padded to its own cache line
+    struct Range {
+        std::atomic<long long> next; // Next item to hand out
+        long long end; // One past the last item
+        char padding[48]; // Keeps the counters of two threads on different cache lines
+    };
+
+    // What one search expands
+    struct Search {
+        const WeightedGraph::GridGraph* grid; // Searched grid
+        const int* ignition; // Ignition turns, only for the prisoner
+        int* distance; // Level of every cell
+        int* prev; // Predecessor of every cell, only for the prisoner
+        int unvisited; // Distance of the cells not reached yet
+        int end; // Exit of the prisoner, -1 for the fire
+    };
+
+    int threads; // Number of threads, the calling thread included
+    std::unique_ptr<Range[]> ranges; // Work of each thread during a parallel level
+    std::vector<std::vector<int>> localQueues; // Cells discovered by each thread during a level
+    std::vector<int> frontier; // Cells of the current level
+    std::vector<int> nextFrontier; // Cells of the next level
+
+    // Parallel phase of a level shared with the helper threads
+    Search search; // Current search
+    int level = 0; // Level being expanded
+    bool bottomUp = false; // Direction of the current level
+    std::atomic<bool> reachedEnd; // The exit was reached during the level
+
+    std::mutex mutex; // Protects the phase counters
+    std::condition_variable phaseStarted; // A new level phase started or the search ended
+    std::condition_variable phaseDone; // A helper finished its share of the phase
+    long long generation = 0; // Number of phases started
+    int running = 0; // Helpers still working on the current phase
+    bool stopping = false; // The helpers must exit
+
+    // Expand every level of a search from the given sources, return true if the exit was reached
+    bool run(const Search& search, const std::vector<int>& sources);
+
+    // Expand the cells of the current phase that belong to a thread, stealing from the others once done
+    void expand(int thread);
+
+    // Top-down or bottom-up expansion of one chunk of work
+    void expandTopDown(long long first, long long last, std::vector<int>& queue);
+    void expandBottomUp(long long first, long long last, std::vector<int>& queue);
+
+    // Check if a cell can be reached at the given level
+    bool canEnter(int cell, int nextLevel) const;
+
+    // Body of the helper threads, started when generation phases had already run
+    void help(int thread, long long started);
+};
+
+#endif //LABYRINTH_PARALLELBFS_H
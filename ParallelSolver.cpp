@@ -0,0 +1,148 @@
+#include "ParallelSolver.h" // Include the declaration of the ParallelSolver class
+#include <thread> // Worker and writer threads
+
+ParallelSolver::ParallelSolver(int threads, FILE* output, FILE* statsOutput)
+        : threads(threads < 1 ? 1 : threads), output(output), statsOutput(statsOutput) {}
+
+bool ParallelSolver::run(BatchReader& reader, long long instances, std::string& error) {
+    // Prepare the slots, all free
+    slots.assign(static_cast<size_t>(threads) * 4, Slot());
+    window.assign(slots.size(), nullptr);
+    freeSlots.clear();
+    pending.clear();
+    for (Slot& slot : slots)
+        freeSlots.push_back(&slot);
+    parsed = 0;
+    inputDone = false;
+
+    // Start the writer and the workers
+    std::thread writer(&ParallelSolver::write, this);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++)
+        workers.emplace_back(&ParallelSolver::work, this);
+
+    // Parse the instances into free slots, the parsing itself runs outside the lock
+    bool valid = true;
+    for (long long i = 0; i < instances; i++) {
+        Slot* slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotFreed.wait(lock, [this] { return !freeSlots.empty(); });
+            slot = freeSlots.front();
+            freeSlots.pop_front();
+        }
+
+        long long n = 0, m = 0;
+        bool read = reader.readDimensions(n, m, error);
+        if (read) {
+            slot->giant = n * m >= PackedGrid::MinimumCells;
+            read = slot->giant ? reader.readRows(slot->packed, n, m, error)
+                               : reader.readRows(slot->grid, n, m, slot->start, slot->end, error);
+        }
+        if (!read) {
+            valid = false;
+            std::lock_guard<std::mutex> lock(mutex);
+            freeSlots.push_back(slot);
+            break;
+        }
+        slot->index = i;
+        slot->prisoners = reader.prisoners();
+        slot->exits = reader.exits();
+        slot->solved = false;
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            window[static_cast<size_t>(i % static_cast<long long>(window.size()))] = slot;
+            pending.push_back(slot);
+            parsed++;
+        }
+        instanceReady.notify_one();
+    }
+
+    // Let the threads drain the remaining instances and stop
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        inputDone = true;
+    }
+    instanceReady.notify_all();
+    resultReady.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+    writer.join();
+    return valid;
+}
+
+void ParallelSolver::work() {
+    // Each worker owns its search buffers, reused by all its instances
+    Labyrinth::SearchBuffers buffers;
+    while (true) {
+        Slot* slot;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            instanceReady.wait(lock, [this] { return !pending.empty() || inputDone; });
+            if (pending.empty())
+                return;
+            slot = pending.front();
+            pending.pop_front();
+        }
+
+        if (statsOutput != nullptr) {
+            slot->stats.clear();
+            buffers.stats = &slot->stats;
+        }
+        if (slot->giant)
+            slot->result.assign(1, slot->packed.escapeDecision(nullptr, buffers.stats));
+        else
+            Labyrinth::decideInstance(slot->grid, slot->prisoners, slot->exits, slot->start, slot->end, buffers,
+                                      slot->result);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slot->solved = true;
+        }
+        resultReady.notify_one();
+    }
+}
+
+void ParallelSolver::write() {
+    // Emit the results in input order, a slot is recycled once its result is written
+    std::string out, statsOut;
+    out.reserve(1 << 16);
+    long long next = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            Slot** waiting = &window[static_cast<size_t>(next % static_cast<long long>(window.size()))];
+            resultReady.wait(lock, [&] {
+                return (next < parsed && (*waiting)->solved) || (inputDone && next >= parsed);
+            });
+            if (next >= parsed)
+                break;
+            out += (*waiting)->result;
+            out += '\n';
+            if (statsOutput != nullptr) {
+                statsOut += (*waiting)->stats.toJson(next + 1, (*waiting)->result);
+                statsOut += '\n';
+            }
+            freeSlots.push_back(*waiting);
+        }
+        slotFreed.notify_one();
+
+        if (out.size() >= (1 << 16)) {
+            std::fwrite(out.data(), 1, out.size(), output);
+            out.clear();
+        }
+        if (statsOut.size() >= (1 << 16)) {
+            std::fwrite(statsOut.data(), 1, statsOut.size(), statsOutput);
+            statsOut.clear();
+        }
+        next++;
+    }
+
+    std::fwrite(out.data(), 1, out.size(), output);
+    std::fflush(output);
+    if (statsOutput != nullptr) {
+        std::fwrite(statsOut.data(), 1, statsOut.size(), statsOutput);
+        std::fflush(statsOutput);
+    }
+}
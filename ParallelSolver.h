@@ -0,0 +1,67 @@
+#ifndef LABYRINTH_PARALLELSOLVER_H
+#define LABYRINTH_PARALLELSOLVER_H
+
+#include "Labyrinth.h" // Include the declaration of the Labyrinth class
+#include "BatchReader.h" // Include the declaration of the BatchReader class
+#include "PackedGrid.h" // Include the packed grid of the giant instances
+#include <condition_variable> // Waiting for instances and results
+#include <cstdio> // Buffered output of the results
+#include <deque> // Queues of instance slots
+#include <mutex> // Protection of the shared queues
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+
+// Worker pool solving independent instances in parallel and printing the results in input order
+// The calling thread parses the instances, N workers solve them with their own search buffers
+// and a writer thread emits the results through a reorder window.
+// Giant instances (PackedGrid::MinimumCells cells or more) are read into the packed grid of their slot, as in the serial batch
+class ParallelSolver {
+public:
+    // Solver with the given number of worker threads writing to output
+    // When statsOutput is given, the statistics of every instance are written there as JSON lines, in input order
+    ParallelSolver(int threads, FILE* output, FILE* statsOutput = nullptr);
+
+    // Solve the given number of instances from the reader
+    // Return false and describe the problem in error if an instance is malformed, the results before it are still printed
+    bool run(BatchReader& reader, long long instances, std::string& error);
+
+private:
+    // Parsed instance waiting for its solver or for its result to be written
+    struct Slot {
+        WeightedGraph::GridGraph grid; // Labels of the labyrinth, memory reused across instances
+        PackedGrid packed; // Cells of a giant instance, memory reused across instances
+        bool giant = false; // The instance is in packed rather than in grid
+        long long index = 0; // Position of the instance in the input
+        int start = 0; // Vertex number of the first prisoner
+        int end = 0; // Vertex number of the first exit
+        long long prisoners = 0; // Number of prisoners
+        long long exits = 0; // Number of exits
+        std::string result; // One 'Y' or 'N' per prisoner once solved
+        bool solved = false; // The result is ready to be written
+        SolverStats stats; // Statistics of the solve, only filled when they are written
+    };
+
+    int threads; // Number of worker threads
+    FILE* output; // Destination of the results
+    FILE* statsOutput; // Destination of the statistics, null when they are not collected
+
+    std::vector<Slot> slots; // Every slot, 4 per worker so that parsing runs ahead of solving
+    std::vector<Slot*> window; // Slot of the instance index % window size, the reorder buffer
+    std::deque<Slot*> freeSlots; // Slots ready to receive an instance
+    std::deque<Slot*> pending; // Parsed instances waiting for a worker
+    long long parsed = 0; // Number of instances handed to the workers
+    bool inputDone = false; // The reader has no more instances
+
+    std::mutex mutex; // Protects the queues, the window and the counters
+    std::condition_variable slotFreed; // A slot returned to freeSlots
+    std::condition_variable instanceReady; // An instance was added to pending or the input ended
+    std::condition_variable resultReady; // A result was stored or the input ended
+
+    // Body of a worker thread: solve pending instances until the input ends
+    void work();
+
+    // Body of the writer thread: print the results in input order
+    void write();
+};
+
+#endif //LABYRINTH_PARALLELSOLVER_H
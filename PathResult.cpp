@@ -0,0 +1,24 @@
+#include "PathResult.h" // Include the declaration of the PathResult class
+
+std::vector<char> PathResult::directions() const {
+    // Unpack the moves into direction chars
+    std::vector<char> chars(moves);
+    for (size_t step = 0; step < moves; step++)
+        chars[step] = directionChar(step);
+    return chars;
+}
+
+void PathResult::assign(const std::vector<int>& path, int rows) {
+    // Copy the cells and encode the moves, the first step that is not a grid move ends the moves
+    cells.assign(path.begin(), path.end());
+    packedMoves.assign((cells.size() + 2) / 4, 0);
+    moves = steps();
+    for (size_t index = 0; index + 1 < cells.size(); index++) {
+        int step;
+        if (!encode(cells[index + 1] - cells[index], rows, step)) {
+            moves = index;
+            break;
+        }
+        packedMoves[index >> 2] |= static_cast<uint8_t>(step << ((index & 3) << 1));
+    }
+}
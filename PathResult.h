@@ -0,0 +1,100 @@
+#ifndef LABYRINTH_PATHRESULT_H
+#define LABYRINTH_PATHRESULT_H
+
+#include <cstddef> // Size type
+#include <cstdint> // Fixed width integers
+#include <vector> // Dynamic array functionality using vectors
+
+// Path found by a search: the cell numbers from the start to the end and the move of every step packed on 2 bits
+// The moves are written while the predecessors are walked back, no vertex is copied and no reversal is needed
+class PathResult {
+public:
+    // Move of one step, in the order of the direction chars 'U', 'T', 'R' and 'L'
+    enum Direction : uint8_t {
+        Up = 0, // Next line, + rows
+        Down = 1, // Previous line, - rows
+        Right = 2, // Next cell of the line, + 1
+        Left = 3 // Previous cell of the line, - 1
+    };
+
+    std::vector<int32_t> cells; // Cell numbers from the start to the end, empty when there is no path
+    std::vector<uint8_t> packedMoves; // Four moves per byte, step k in bits 2 * (k % 4)
+    size_t moves = 0; // Number of leading steps between grid neighbours, the moves stop at the first other step
+
+    // Forget the path while keeping the allocated memory
+    void clear() {
+        cells.clear();
+        packedMoves.clear();
+        moves = 0;
+    }
+
+    // Check if a path was found
+    bool empty() const {
+        return cells.empty();
+    }
+
+    // Number of steps of the path
+    size_t steps() const {
+        return cells.empty() ? 0 : cells.size() - 1;
+    }
+
+    // Move of a step, step must be smaller than moves
+    Direction move(size_t step) const {
+        return static_cast<Direction>((packedMoves[step >> 2] >> ((step & 3) << 1)) & 3);
+    }
+
+    // Direction char of a step ('U', 'T', 'R' or 'L')
+    char directionChar(size_t step) const {
+        return "UTRL"[move(step)];
+    }
+
+    // Direction chars of every move, as played by the turn by turn simulation
+    std::vector<char> directions() const;
+
+    // Take the path from its cells, from the start to the end, on a grid of rows cells per line
+    void assign(const std::vector<int>& path, int rows);
+
+    // Rebuild the path ending at end by walking prevOf(cell) back to -1, on a grid of rows cells per line
+    template <typename PrevOf>
+    void rebuild(int end, int rows, PrevOf prevOf) {
+        // First walk: length of the path, so the cells can be written in place from the back
+        size_t length = 0;
+        for (int current = end; current != -1; current = prevOf(current))
+            length++;
+        cells.resize(length);
+        packedMoves.assign((length + 2) / 4, 0);
+
+        // Second walk: cells and moves, the first step that is not a grid move ends the moves
+        moves = length - 1;
+        size_t index = length - 1;
+        for (int current = end; current != -1; current = prevOf(current), index--) {
+            cells[index] = current;
+            if (index + 1 < length) {
+                int step;
+                if (!encode(cells[index + 1] - current, rows, step)) {
+                    moves = index;
+                } else {
+                    packedMoves[index >> 2] |= static_cast<uint8_t>(step << ((index & 3) << 1));
+                }
+            }
+        }
+    }
+
+private:
+    // Move between two cells differing by movement, vertical moves first since with one cell per line they also differ by 1
+    static bool encode(int movement, int rows, int& step) {
+        if (movement == rows)
+            step = Up;
+        else if (movement == -rows)
+            step = Down;
+        else if (movement == 1)
+            step = Right;
+        else if (movement == -1)
+            step = Left;
+        else
+            return false;
+        return true;
+    }
+};
+
+#endif //LABYRINTH_PATHRESULT_H
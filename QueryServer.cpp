@@ -0,0 +1,265 @@
+#include "QueryServer.h" // Include the declaration of the QueryServer class
+#include <algorithm> // Include the algorithm header for std::sort
+#include <cerrno> // Include the cerrno header for interrupted accepts
+#include <cstdlib> // Include the cstdlib header for free
+#include <cstring> // Include the cstring header for the socket address
+#include <sstream> // Include the sstream header for parsing the queries
+#include <sys/socket.h> // Include the socket header for the UNIX socket
+#include <sys/un.h> // Include the UNIX domain socket address
+#include <thread> // Include the thread header for the connections
+#include <unistd.h> // Include the unistd header for close and unlink
+
+const size_t QueryServer::DefaultBudget;
+
+namespace {
+    // Key of a set of cells, the cells are sorted
+    std::string keyOf(char kind, const std::vector<int>& cells) {
+        std::string key(1, kind);
+        for (int cell : cells) {
+            key += std::to_string(cell);
+            key += ',';
+        }
+        return key;
+    }
+}
+
+QueryServer::QueryServer(const WeightedGraph::GridGraph& maze, size_t budget) : maze(maze), budget(budget) {
+    // The prisoners, fires and exits of the maze become free cells, each query places its own
+    for (int v = 0; v < this->maze.size(); v++) {
+        char& label = this->maze.labels[v];
+        if (label == 'F')
+            mazeFires.push_back(v);
+        else if (label == 'S')
+            mazeExits.push_back(v);
+        if (label == 'D' || label == 'F' || label == 'S')
+            label = '.';
+    }
+}
+
+std::shared_ptr<const QueryServer::Field> QueryServer::lookup(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = index.find(key);
+    if (found == index.end())
+        return nullptr;
+    recent.splice(recent.begin(), recent, found->second);
+    hits++;
+    return found->second->field;
+}
+
+void QueryServer::store(const std::string& key, const std::shared_ptr<const Field>& field) {
+    std::lock_guard<std::mutex> lock(mutex);
+    misses++;
+
+    // Another session may have computed the same field meanwhile, and a field larger than the budget is not kept
+    size_t bytes = field->bytes();
+    if (index.count(key) != 0 || bytes > budget)
+        return;
+    while (used + bytes > budget) {
+        used -= recent.back().bytes;
+        index.erase(recent.back().key);
+        recent.pop_back();
+        evictions++;
+    }
+    recent.push_front(Entry{key, field, bytes});
+    index[key] = recent.begin();
+    used += bytes;
+}
+
+std::shared_ptr<const QueryServer::Field> QueryServer::deadlines(const std::vector<int>& fires, const std::vector<int>& exits,
+                                                                 Session& session) {
+    std::string fireKey = keyOf('F', fires);
+    std::string fieldKey = fireKey + keyOf('S', exits);
+    std::shared_ptr<const Field> field = lookup(fieldKey);
+    if (field != nullptr)
+        return field;
+
+    // Place the fires and the exits of the query on the session's copy of the maze
+    WeightedGraph::GridGraph& scratch = session.scratch;
+    Labyrinth::SearchBuffers& buffers = session.buffers;
+    scratch.lines = maze.lines;
+    scratch.rows = maze.rows;
+    scratch.labels.assign(maze.labels.begin(), maze.labels.end());
+    scratch.costs.assign(maze.costs.begin(), maze.costs.end());
+    scratch.fireDelays.assign(maze.fireDelays.begin(), maze.fireDelays.end());
+    for (int cell : fires)
+        scratch.labels[cell] = 'F';
+    for (int cell : exits)
+        scratch.labels[cell] = 'S';
+
+    // Ignition turns are shared by every set of exits
+    std::shared_ptr<const Field> fire = lookup(fireKey);
+    if (fire != nullptr) {
+        buffers.ignition.assign(fire->ignition.begin(), fire->ignition.end());
+    } else {
+        Labyrinth::fireArrivalTimes(scratch, buffers);
+        std::shared_ptr<Field> computed = std::make_shared<Field>();
+        computed->ignition = buffers.ignition;
+        store(fireKey, computed);
+    }
+
+    Labyrinth::exitDeadlines(scratch, buffers);
+    std::shared_ptr<Field> computed = std::make_shared<Field>();
+    computed->latest = buffers.backward;
+    computed->next = buffers.next;
+    store(fieldKey, computed);
+    return computed;
+}
+
+bool QueryServer::parseCells(const std::string& text, std::vector<int>& cells) const {
+    cells.clear();
+    std::istringstream list(text);
+    std::string item;
+    while (std::getline(list, item, ';')) {
+        int i = 0, j = 0;
+        char comma = 0, extra = 0;
+        std::istringstream pair(item);
+        if (!(pair >> i >> comma >> j) || comma != ',' || (pair >> extra))
+            return false;
+        if (i < 0 || i >= maze.lines || j < 0 || j >= maze.rows || maze.labels[i * maze.rows + j] == '#')
+            return false;
+        cells.push_back(i * maze.rows + j);
+    }
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    return !cells.empty();
+}
+
+bool QueryServer::answer(const std::string& line, Session& session, std::string& reply) {
+    std::istringstream query(line);
+    std::string command;
+    query >> command;
+    reply.clear();
+
+    if (command == "quit")
+        return false;
+    if (command == "info") {
+        reply = std::to_string(maze.lines) + " " + std::to_string(maze.rows);
+        return true;
+    }
+    if (command == "stats") {
+        std::lock_guard<std::mutex> lock(mutex);
+        reply = "entries " + std::to_string(recent.size()) + " bytes " + std::to_string(used) + " hits " + std::to_string(hits)
+                + " misses " + std::to_string(misses) + " evictions " + std::to_string(evictions);
+        return true;
+    }
+    if (command != "escape" && command != "route") {
+        reply = "E unknown command, expected info, escape, route, stats or quit";
+        return true;
+    }
+
+    // Prisoner cell, then the optional sets of exits and fires
+    int i = 0, j = 0;
+    if (!(query >> i >> j) || i < 0 || i >= maze.lines || j < 0 || j >= maze.rows) {
+        reply = "E expected the line and column of the prisoner inside the maze";
+        return true;
+    }
+    std::vector<int> exits = mazeExits, fires = mazeFires;
+    std::string option, list;
+    while (query >> option) {
+        if (!(query >> list) || (option != "exits" && option != "fires")) {
+            reply = "E expected exits LIST or fires LIST";
+            return true;
+        }
+        if (!parseCells(list, option == "exits" ? exits : fires)) {
+            reply = "E invalid " + option + " list, expected i,j;i,j;... of cells that are not walls";
+            return true;
+        }
+    }
+    int start = i * maze.rows + j;
+    if (maze.labels[start] != '.' || std::binary_search(exits.begin(), exits.end(), start)
+        || std::binary_search(fires.begin(), fires.end(), start)) {
+        reply = "E the prisoner must stand on a free cell";
+        return true;
+    }
+
+    // Same rule as Labyrinth::escapeDecisions, the route follows the next cells of the field
+    std::shared_ptr<const Field> field = deadlines(fires, exits, session);
+    if (field->latest[start] < 0) {
+        reply = "N";
+        return true;
+    }
+    std::vector<int> route;
+    for (int current = start; current != -1; current = field->next[current])
+        route.push_back(current);
+    if (command == "escape") {
+        // Length of the route along the latest safe turns, which may be longer than the shortest escape
+        reply = "Y " + std::to_string(route.size() - 1);
+    } else {
+        std::vector<char> directions = Labyrinth::movementDirections(route, maze.rows);
+        reply = "Y " + std::string(directions.begin(), directions.end());
+    }
+    return true;
+}
+
+void QueryServer::serveStream(FILE* input, FILE* output) {
+    // One answer per line, flushed at once since the client waits for it
+    Session session;
+    std::string reply;
+    char* line = nullptr;
+    size_t capacity = 0;
+    ssize_t length;
+    while ((length = getline(&line, &capacity, input)) > 0) {
+        while (length > 0 && (line[length - 1] == '\n' || line[length - 1] == '\r'))
+            line[--length] = '\0';
+        if (!answer(std::string(line, static_cast<size_t>(length)), session, reply))
+            break;
+        reply += '\n';
+        std::fwrite(reply.data(), 1, reply.size(), output);
+        std::fflush(output);
+    }
+    free(line);
+}
+
+void QueryServer::serveConnection(int fd) {
+    // Separate streams for reading and writing the socket
+    FILE* input = fdopen(fd, "r");
+    int outputFd = dup(fd);
+    FILE* output = outputFd >= 0 ? fdopen(outputFd, "w") : nullptr;
+    if (input != nullptr && output != nullptr)
+        serveStream(input, output);
+    if (output != nullptr)
+        std::fclose(output);
+    else if (outputFd >= 0)
+        close(outputFd);
+    if (input != nullptr)
+        std::fclose(input);
+    else
+        close(fd);
+}
+
+bool QueryServer::serveSocket(const std::string& path, std::string& error) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        error = "socket path too long: " + path;
+        return false;
+    }
+    std::strcpy(address.sun_path, path.c_str());
+
+    // Replace a socket left by a previous server
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        error = "cannot create a socket.";
+        return false;
+    }
+    unlink(path.c_str());
+    if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 64) < 0) {
+        error = "cannot listen on " + path + ".";
+        close(listener);
+        return false;
+    }
+
+    // Every client gets its own thread and session, the cache is shared
+    while (true) {
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED)
+                continue;
+            error = "cannot accept connections on " + path + ".";
+            close(listener);
+            return false;
+        }
+        std::thread(&QueryServer::serveConnection, this, client).detach();
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef LABYRINTH_QUERYSERVER_H
+#define LABYRINTH_QUERYSERVER_H
+
+#include "Labyrinth.h" // Include the declaration of the Labyrinth class
+#include <cstddef> // Size types
+#include <cstdio> // Streams of the served lines
+#include <list> // Recency order of the cached fields
+#include <memory> // Fields shared between the cache and the queries using them
+#include <mutex> // Protection of the cache
+#include <string> // String manipulation functions
+#include <unordered_map> // Cached fields by key
+#include <vector> // Dynamic array functionality using vectors
+
+// Resident server answering many questions about one maze, one line per query and one line per answer:
+//   info                               -> "lines rows"
+//   escape i j [exits LIST] [fires LIST] -> "Y moves" or "N", the moves of the route, not always the shortest escape
+//   route i j [exits LIST] [fires LIST]  -> "Y directions" or "N"
+//   stats                              -> cache entries, bytes, hits, misses and evictions
+//   quit                               -> end of the session
+// (i, j) is the line and column of the prisoner, from 0. LIST is "i,j;i,j;..." and replaces the exits ('S')
+// or the fires ('F') of the maze, which are used otherwise. Errors are answered with "E message".
+// The ignition turns of each set of fires and the latest safe turns of each set of fires and exits are cached,
+// least recently used first out once the memory budget is reached, so repeated what-if questions are lookups
+class QueryServer {
+public:
+    // Default memory budget of the caches
+    static const size_t DefaultBudget = static_cast<size_t>(256) << 20;
+
+    // Scratch state of one client, a session must not be shared between threads
+    class Session {
+    public:
+        Labyrinth::SearchBuffers buffers; // Buffers of the fire and exit passes
+        WeightedGraph::GridGraph scratch; // Maze with the fires and exits of the query
+    };
+
+    // Server over a copy of the maze, the caches hold at most budget bytes
+    explicit QueryServer(const WeightedGraph::GridGraph& maze, size_t budget = DefaultBudget);
+
+    // Answer one query line, return false when the line ends the session
+    bool answer(const std::string& line, Session& session, std::string& reply);
+
+    // Answer the lines of input on output until the input ends or a quit line
+    void serveStream(FILE* input, FILE* output);
+
+    // Listen on a UNIX socket and serve every connection on its own thread, return only on error
+    bool serveSocket(const std::string& path, std::string& error);
+
+private:
+    // Cached per-cell values: ignition turns for a set of fires, or latest turns and next cells for fires and exits
+    struct Field {
+        std::vector<int> ignition; // Turn at which each cell catches fire
+        std::vector<int> latest; // Latest turn at which a prisoner may stand on each cell, -1 when no escape
+        std::vector<int> next; // Next cell of the escape, -1 for none
+
+        size_t bytes() const {
+            return (ignition.capacity() + latest.capacity() + next.capacity()) * sizeof(int);
+        }
+    };
+
+    // Cache entry, the most recently used first
+    struct Entry {
+        std::string key; // Sets of fires and exits the field belongs to
+        std::shared_ptr<const Field> field; // Cached field
+        size_t bytes; // Memory charged to the budget
+    };
+
+    WeightedGraph::GridGraph maze; // Labyrinth with the prisoners, fires and exits turned into free cells
+    std::vector<int> mazeFires; // Fires of the maze, used when a query gives none
+    std::vector<int> mazeExits; // Exits of the maze, used when a query gives none
+
+    std::mutex mutex; // Protects the cache and its counters
+    std::list<Entry> recent; // Entries from the most to the least recently used
+    std::unordered_map<std::string, std::list<Entry>::iterator> index; // Entry of each key
+    size_t budget; // Largest memory of the cached fields
+    size_t used = 0; // Memory of the cached fields
+    long long hits = 0; // Queries answered from the cache
+    long long misses = 0; // Fields computed
+    long long evictions = 0; // Fields dropped to respect the budget
+
+    // Cached field of a key, null when absent, the entry becomes the most recent
+    std::shared_ptr<const Field> lookup(const std::string& key);
+
+    // Cache a field, evicting the least recently used entries beyond the budget
+    void store(const std::string& key, const std::shared_ptr<const Field>& field);
+
+    // Latest turns toward the given exits with the given fires, from the cache or computed in the session
+    std::shared_ptr<const Field> deadlines(const std::vector<int>& fires, const std::vector<int>& exits, Session& session);
+
+    // Parse "i,j;i,j;..." into sorted vertex numbers of non-wall cells, return false on a malformed or invalid list
+    bool parseCells(const std::string& text, std::vector<int>& cells) const;
+
+    // Serve one accepted connection until the client leaves
+    void serveConnection(int fd);
+};
+
+#endif //LABYRINTH_QUERYSERVER_H
@@ -0,0 +1,87 @@
+#ifndef LABYRINTH_RADIXHEAP_H
+#define LABYRINTH_RADIXHEAP_H
+
+#include <cstddef> // Size type
+#include <cstdint> // Fixed width integers
+#include <vector> // Dynamic array functionality using vectors
+
+// Monotone min-heap on 32-bit keys (radix heap): a key pushed is never smaller than the last key popped,
+// as in Dijkstra's algorithm with non-negative costs. An entry sits in the bucket of the highest bit where its key
+// differs from the last key popped, so it moves at most 32 times, whatever the range of the keys.
+// An item may be pushed several times, every entry is popped
+template <typename Item>
+class RadixHeap {
+public:
+    // Remove every entry, memory is kept
+    void clear() {
+        for (std::vector<Entry>& bucket : buckets)
+            bucket.clear();
+        last = 0;
+        count = 0;
+    }
+
+    // Check if the heap is empty
+    bool empty() const {
+        return count == 0;
+    }
+
+    // Number of entries in the heap
+    size_t size() const {
+        return count;
+    }
+
+    // Add an entry, key must not be smaller than the last key popped
+    void push(Item item, uint32_t key) {
+        buckets[bucketOf(key)].push_back(Entry{key, item});
+        count++;
+    }
+
+    // Remove an entry of smallest key and store its key in key
+    Item pop(uint32_t& key) {
+        if (buckets[0].empty()) {
+            // The smallest key of the first non-empty bucket becomes the reference, its entries all move to lower buckets
+            int first = 1;
+            while (buckets[first].empty())
+                first++;
+            std::vector<Entry>& source = buckets[first];
+            last = source[0].key;
+            for (const Entry& entry : source)
+                if (entry.key < last)
+                    last = entry.key;
+            for (const Entry& entry : source)
+                buckets[bucketOf(entry.key)].push_back(entry);
+            source.clear();
+        }
+        Entry entry = buckets[0].back();
+        buckets[0].pop_back();
+        count--;
+        key = entry.key;
+        return entry.item;
+    }
+
+private:
+    // Queued item and its key
+    struct Entry {
+        uint32_t key; // Key of the entry
+        Item item; // Queued item
+    };
+
+    std::vector<Entry> buckets[33]; // Entries by highest bit differing from last, bucket 0 holds the keys equal to last
+    uint32_t last = 0; // Last key popped
+    size_t count = 0; // Number of entries
+
+    // Bucket of a key: 0 when it equals last, else 1 + the index of the highest bit where they differ
+    int bucketOf(uint32_t key) const {
+        uint32_t difference = key ^ last;
+#if defined(__GNUC__)
+        return difference == 0 ? 0 : 32 - __builtin_clz(difference);
+#else
+        int bucket = 0;
+        for (; difference != 0; difference >>= 1)
+            bucket++;
+        return bucket;
+#endif
+    }
+};
+
+#endif //LABYRINTH_RADIXHEAP_H
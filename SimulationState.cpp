@@ -0,0 +1,93 @@
+#include "SimulationState.h" // Include the declaration of the SimulationState class
+
+void SimulationState::reset(const WeightedGraph::GridGraph& grid, int start) {
+    // Nothing burns but the fires of the terrain, which form the front of turn 0
+    this->grid = &grid;
+    size_t words = (static_cast<size_t>(grid.size()) + 63) / 64;
+    burning.assign(words, 0);
+    trail.assign(words, 0);
+    fronts[0].clear();
+    fronts[1].clear();
+    for (int v = 0; v < grid.size(); v++) {
+        if (grid.labels[v] == 'F') {
+            burning[v >> 6] |= uint64_t(1) << (v & 63);
+            fronts[0].push_back(v);
+        }
+    }
+    turn = 0;
+    position = start;
+}
+
+bool SimulationState::spread() {
+    // Read the front of this turn, write the front of the next one
+    const std::vector<int>& front = fronts[turn & 1];
+    std::vector<int>& next = fronts[(turn + 1) & 1];
+    next.clear();
+    turn++;
+
+    const std::vector<char>& labels = grid->labels;
+    int rows = grid->rows, numberV = grid->size();
+    bool lost = false;
+    auto ignite = [&](int cell) {
+        // Walls never burn, burning cells are left unchanged, trail cells burn
+        uint64_t bit = uint64_t(1) << (cell & 63);
+        if (labels[cell] == '#' || (burning[cell >> 6] & bit))
+            return;
+        burning[cell >> 6] |= bit;
+        next.push_back(cell);
+        lost = lost || cell == position || labels[cell] == 'S';
+    };
+    for (int v : front) {
+        int j = v % rows;
+        if (j != 0)
+            ignite(v - 1); // Cell on the left
+        if (j != rows - 1)
+            ignite(v + 1); // Cell on the right
+        if (v >= rows)
+            ignite(v - rows); // Cell on the previous line
+        if (v + rows < numberV)
+            ignite(v + rows); // Cell on the next line
+    }
+    return lost;
+}
+
+bool SimulationState::move(char direction) {
+    // Check for victory: an exit next to the prisoner
+    const std::vector<char>& labels = grid->labels;
+    int rows = grid->rows, numberV = grid->size();
+    int j = position % rows;
+    if ((j != 0 && labels[position - 1] == 'S') || (j != rows - 1 && labels[position + 1] == 'S')
+        || (position >= rows && labels[position - rows] == 'S') || (position + rows < numberV && labels[position + rows] == 'S'))
+        return true;
+
+    // Move the prisoner according to the direction
+    int next = position;
+    if (direction == 'U' && position + rows < numberV)
+        next = position + rows;
+    else if (direction == 'T' && position - rows >= 0)
+        next = position - rows;
+    else if (direction == 'L' && j != 0)
+        next = position - 1;
+    else if (direction == 'R' && j != rows - 1)
+        next = position + 1;
+
+    // The prisoner enters the free cells and the exits, the cell they leave joins the trail
+    if (next != position && (labels[next] == '.' || labels[next] == 'S') && !isBurning(next) && !isTrail(next)) {
+        trail[position >> 6] |= uint64_t(1) << (position & 63);
+        position = next;
+    }
+    return false;
+}
+
+char SimulationState::play(const std::vector<char>& directions, int& turns) {
+    // Each turn the fire spreads, then the prisoner moves
+    turns = 0;
+    for (char direction : directions) {
+        turns++;
+        if (spread())
+            return 'N'; // Lost
+        if (move(direction))
+            return 'Y'; // Won
+    }
+    return 'N'; // Lost
+}
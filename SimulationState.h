@@ -0,0 +1,52 @@
+#ifndef LABYRINTH_SIMULATIONSTATE_H
+#define LABYRINTH_SIMULATIONSTATE_H
+
+#include "WeightedGraph.h" // Include the declaration of the WeightedGraph class
+#include <cstdint> // Fixed width integers
+#include <vector> // Dynamic array functionality using vectors
+
+// Mutable state of one turn by turn game played on a grid that is only read
+// The grid is the immutable terrain, the state holds what a game changes: the burning cells and the prisoner's trail
+// as bitsets, the prisoner's cell, and the fire front of the current turn and of the next one.
+// A turn reads the front of turn t and writes the front of turn t + 1, a cell is marked burning as soon as it is queued,
+// so the fire never spreads twice in one turn and no pass over the grid is needed between turns.
+// Any number of states, one per thread, can play games on the same grid at the same time
+class SimulationState {
+public:
+    // Start a game on grid with the prisoner on start, memory is kept between games
+    void reset(const WeightedGraph::GridGraph& grid, int start);
+
+    // Spread the fire by one turn from the cells that ignited on the previous turn
+    // Return true if it reaches the prisoner or an exit, the game is then lost
+    bool spread();
+
+    // Play the prisoner's move of a turn ('U', 'T', 'L' or 'R'), return true if they stand next to an exit and win
+    // The prisoner stays in place when the move leaves the grid or enters a wall, a burning cell or their trail
+    bool move(char direction);
+
+    // Play the moves turn by turn and return the result (Y for win, N for loss), turns receives the number of turns played
+    char play(const std::vector<char>& directions, int& turns);
+
+    // Cell of the prisoner
+    int prisoner() const {
+        return position;
+    }
+
+    // Check if a cell is burning or was visited by the prisoner
+    bool isBurning(int cell) const {
+        return (burning[cell >> 6] >> (cell & 63)) & 1;
+    }
+    bool isTrail(int cell) const {
+        return (trail[cell >> 6] >> (cell & 63)) & 1;
+    }
+
+private:
+    const WeightedGraph::GridGraph* grid = nullptr; // Terrain of the game, never written
+    std::vector<uint64_t> burning; // Bit set of the burning cells
+    std::vector<uint64_t> trail; // Bit set of the cells the prisoner left
+    std::vector<int> fronts[2]; // Cells that ignited on the current turn and on the next one, by parity of the turn
+    int turn = 0; // Number of spreads played
+    int position = -1; // Cell of the prisoner
+};
+
+#endif //LABYRINTH_SIMULATIONSTATE_H
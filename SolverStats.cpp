@@ -0,0 +1,15 @@
+#include "SolverStats.h" // Include the declaration of the SolverStats struct
+#include <cstdio> // Include the cstdio header for snprintf
+
+std::string SolverStats::toJson(long long instance, const std::string& result) const {
+    // The result has one character per prisoner, it goes between the two formatted halves
+    char head[64], tail[512];
+    std::snprintf(head, sizeof(head), "{\"instance\": %lld, \"result\": \"", instance);
+    std::snprintf(tail, sizeof(tail),
+                  "\", \"vertices_expanded\": %lld, \"edges_relaxed\": %lld, "
+                  "\"heap_pushes\": %lld, \"heap_pops\": %lld, \"peak_open_set\": %lld, \"simulation_turns\": %lld, "
+                  "\"fire_ns\": %lld, \"search_ns\": %lld, \"simulation_ns\": %lld}",
+                  verticesExpanded, edgesRelaxed, heapPushes, heapPops, peakOpenSet, simulationTurns,
+                  fireNanoseconds, searchNanoseconds, simulationNanoseconds);
+    return head + result + tail;
+}
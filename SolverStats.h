@@ -0,0 +1,50 @@
+#ifndef LABYRINTH_SOLVERSTATS_H
+#define LABYRINTH_SOLVERSTATS_H
+
+#include <chrono> // Timing of the phases
+#include <string> // String manipulation functions
+
+// Counters and phase timings of the solves, filled only when a SolverStats is attached
+// Without one the solvers make no timing call and no output
+struct SolverStats {
+    long long verticesExpanded = 0; // Vertices taken out of the open set or the frontier
+    long long edgesRelaxed = 0; // Edges examined from the expanded vertices
+    long long heapPushes = 0; // Insertions and decreases in the priority queues, appends to the frontiers
+    long long heapPops = 0; // Extractions from the priority queues
+    long long peakOpenSet = 0; // Largest size of the open set or of a frontier
+    long long simulationTurns = 0; // Turns played by the turn by turn simulation
+    long long fireNanoseconds = 0; // Time spent computing the ignition turns
+    long long searchNanoseconds = 0; // Time spent in the path searches
+    long long simulationNanoseconds = 0; // Time spent in the turn by turn simulation
+
+    // Reset every counter and timing
+    void clear() {
+        *this = SolverStats();
+    }
+
+    // One JSON object on one line, without the line break, result holds one 'Y' or 'N' per prisoner
+    std::string toJson(long long instance, const std::string& result) const;
+};
+
+// Add the time elapsed between its construction and its destruction to a counter, nothing when the counter is null
+class PhaseTimer {
+public:
+    explicit PhaseTimer(long long* target) : target(target) {
+        if (target != nullptr)
+            start = std::chrono::steady_clock::now();
+    }
+
+    ~PhaseTimer() {
+        if (target != nullptr)
+            *target += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+private:
+    long long* target; // Counter receiving the elapsed nanoseconds
+    std::chrono::steady_clock::time_point start; // Construction time
+};
+
+#endif //LABYRINTH_SOLVERSTATS_H
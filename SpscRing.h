@@ -0,0 +1,78 @@
+#ifndef LABYRINTH_SPSCRING_H
+#define LABYRINTH_SPSCRING_H
+
+#include <atomic> // Positions shared by the two threads
+#include <cstddef> // Size type
+#include <vector> // Dynamic array functionality using vectors
+
+// Bounded lock-free ring between exactly one producer thread and one consumer thread
+// The producer only writes tail and the consumer only writes head, each publishes its position with a release store
+// and reads the other's with an acquire load, so an item is complete before the other side sees it.
+// Each side keeps a copy of the other's position and only reloads it when the ring looks full or empty.
+// The positions and the copies sit on separate cache lines so the two threads do not invalidate each other's line
+template <typename Item>
+class SpscRing {
+public:
+    // Ring of at least the given capacity, rounded up to a power of two
+    explicit SpscRing(size_t capacity) {
+        size_t size = 1;
+        while (size < capacity)
+            size <<= 1;
+        items.resize(size);
+        mask = size - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: append an item, return false when the ring is full
+    bool push(const Item& item) {
+        size_t position = tail.load(std::memory_order_relaxed);
+        if (position - headCopy > mask) {
+            headCopy = head.load(std::memory_order_acquire);
+            if (position - headCopy > mask)
+                return false;
+        }
+        items[position & mask] = item;
+        tail.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer: take the oldest item, return false when the ring is empty
+    bool pop(Item& item) {
+        size_t position = head.load(std::memory_order_relaxed);
+        if (position == tailCopy) {
+            tailCopy = tail.load(std::memory_order_acquire);
+            if (position == tailCopy)
+                return false;
+        }
+        item = items[position & mask];
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Number of items in the ring, exact only when neither side is moving
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    // Largest number of items
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+private:
+    static const size_t LineSize = 64; // Size of a cache line
+
+    std::vector<Item> items; // Storage, position p holds items[p & mask]
+    size_t mask = 0; // Capacity - 1
+    char separator[LineSize]; // Keeps the consumer's line apart from the shared fields
+    std::atomic<size_t> head{0}; // Position of the next item to pop, written by the consumer
+    size_t tailCopy = 0; // Consumer's copy of tail
+    char consumerLine[LineSize]; // Keeps the consumer's and the producer's positions on separate lines
+    std::atomic<size_t> tail{0}; // Position of the next item to push, written by the producer
+    size_t headCopy = 0; // Producer's copy of head
+    char producerLine[LineSize]; // Keeps the producer's line apart from what follows the ring
+};
+
+#endif //LABYRINTH_SPSCRING_H
@@ -0,0 +1,29 @@
+#include "Terrain.h" // Include the declaration of the Terrain class
+
+const int Terrain::LargestCost;
+const int Terrain::LargestDelay;
+
+bool Terrain::lookup(char symbol, int& cost, int& delay) {
+    // Translate a symbol of the input into its costs
+    delay = 1;
+    switch (symbol) {
+        case '.':
+            cost = 1;
+            return true;
+        case '~':
+            cost = 2;
+            return true;
+        case '=':
+            cost = 2;
+            delay = 2;
+            return true;
+        case '%':
+            cost = 3;
+            return true;
+        default:
+            if (symbol < '1' || symbol > '9')
+                return false;
+            cost = symbol - '0';
+            return true;
+    }
+}
@@ -0,0 +1,22 @@
+#ifndef LABYRINTH_TERRAIN_H
+#define LABYRINTH_TERRAIN_H
+
+// Terrain classes of the free cells: turns the prisoner needs to cross a cell and turns the fire needs to enter it
+// Symbols of the input rows:
+// - '.' : open floor, crossed in 1 turn, burns 1 turn after a burning neighbour
+// - '~' : smoke, crossed in 2 turns, burns after 1 turn
+// - '=' : stairs, crossed in 2 turns, burns after 2 turns
+// - '%' : debris, crossed in 3 turns, burns after 1 turn
+// - '1' to '9' : open floor crossed in that many turns, burns after 1 turn
+// Terrain cells are labelled '.' once read, their costs are kept beside the labels
+class Terrain {
+public:
+    // Largest number of turns to cross a cell and for the fire to enter one
+    static const int LargestCost = 9;
+    static const int LargestDelay = 2;
+
+    // Give the crossing cost and the fire delay of a terrain symbol, false for the other symbols (walls, D, F, S)
+    static bool lookup(char symbol, int& cost, int& delay);
+};
+
+#endif //LABYRINTH_TERRAIN_H
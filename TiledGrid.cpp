@@ -0,0 +1,37 @@
+#include "TiledGrid.h" // Include the declaration of the TiledGrid class
+#include <algorithm> // Include the algorithm header for std::min
+#include <cstring> // Include the cstring header for std::memcpy
+
+const int TiledGrid::TileShift;
+const int TiledGrid::TileSide;
+const int TiledGrid::TileCells;
+const int TiledGrid::MinimumRows;
+const int TiledGrid::MinimumCells;
+
+void TiledGrid::assign(const WeightedGraph::GridGraph& grid) {
+    // Walls everywhere, then each line of the grid is copied one tile line segment at a time
+    lines = grid.lines;
+    rows = grid.rows;
+    tilesPerLine = (rows + 2 + TileSide - 1) >> TileShift;
+    lineStride = tilesPerLine * TileCells;
+    int tileLines = (lines + 2 + TileSide - 1) >> TileShift;
+    labels.assign(static_cast<size_t>(tileLines) * lineStride, '#');
+    for (int i = 0; i < lines; i++) {
+        const char* line = grid.labels.data() + static_cast<size_t>(i) * rows;
+        for (int j = 0; j < rows;) {
+            int length = std::min(TileSide - ((j + 1) & (TileSide - 1)), rows - j);
+            std::memcpy(labels.data() + cellOf(i, j), line + j, static_cast<size_t>(length));
+            j += length;
+        }
+    }
+}
+
+int TiledGrid::rowMajorOf(int cell) const {
+    // Coordinates of the tile, then of the cell inside it, shifted back by the ring
+    int tile = cell >> (2 * TileShift);
+    int i = (tile / tilesPerLine) * TileSide + ((cell >> TileShift) & (TileSide - 1)) - 1;
+    int j = (tile % tilesPerLine) * TileSide + (cell & (TileSide - 1)) - 1;
+    if (i < 0 || i >= lines || j < 0 || j >= rows)
+        return -1;
+    return i * rows + j;
+}
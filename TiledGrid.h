@@ -0,0 +1,79 @@
+#ifndef LABYRINTH_TILEDGRID_H
+#define LABYRINTH_TILEDGRID_H
+
+#include "WeightedGraph.h" // Include the declaration of the WeightedGraph class
+#include <vector> // Dynamic array functionality using vectors
+
+// Cache-blocked copy of a grid: square tiles of TileSide x TileSide cells stored one after the other, a line of tiles
+// after the previous one, the cells of a tile line by line. A move to the next or previous line stays inside the tile
+// (TileSide cells away) 15 times out of 16 instead of crossing a whole line of the grid, so the searches that grow
+// as diamonds touch a few tiles, and a few pages, instead of one cache line and often one page per line.
+// The grid is surrounded by a ring of walls and the last tiles are padded with walls: every cell that is not a wall
+// has its 4 neighbours inside the storage, a move needs neither a bound check nor a division.
+// Only the labels are stored, grids with terrain or explicit edges keep the row-major GridGraph
+class TiledGrid {
+public:
+    // Side of a tile, a line of a tile of int distances fills one 64-byte cache line
+    static const int TileShift = 4;
+    static const int TileSide = 1 << TileShift;
+    static const int TileCells = TileSide * TileSide;
+
+    // The batch mode decides on a TiledGrid the grids of at least MinimumRows cells per line and MinimumCells cells,
+    // whose distance arrays do not fit in the caches; shorter or smaller grids gain nothing from the tiles
+    static const int MinimumRows = 4096;
+    static const int MinimumCells = 1 << 22;
+
+    std::vector<char> labels; // Cell labels in tiled order, walls ('#') in the ring and the padding
+    int lines = 0; // Number of lines of the grid
+    int rows = 0; // Number of cells per line of the grid
+
+    // Check if a grid is worth deciding on a tiled copy: implicit, unit costs, wide and large,
+    // with less than 2^30 cells so that the padded copy is still numbered by int
+    static bool suits(const WeightedGraph::GridGraph& grid) {
+        return grid.edgeOffsets.empty() && !grid.weighted() && grid.rows >= MinimumRows && grid.size() >= MinimumCells
+               && grid.size() < (1 << 30) && grid.lines >= 4 * TileSide;
+    }
+
+    // Copy the labels of an implicit grid, the memory of the previous grid is reused
+    void assign(const WeightedGraph::GridGraph& grid);
+
+    // Number of cells of the storage, ring and padding included
+    int size() const {
+        return static_cast<int>(labels.size());
+    }
+
+    // Storage cell of line i and column j of the grid, from -1 to lines and rows for the ring
+    int cellOf(int i, int j) const {
+        int line = i + 1, column = j + 1;
+        return (line >> TileShift) * lineStride + (column >> TileShift) * TileCells
+               + ((line & (TileSide - 1)) << TileShift) + (column & (TileSide - 1));
+    }
+
+    // Storage cell of a row-major cell number of the grid, and back; -1 for the ring and the padding
+    int cellOf(int rowMajor) const {
+        return cellOf(rowMajor / rows, rowMajor % rows);
+    }
+    int rowMajorOf(int cell) const;
+
+    // Every cell costs one turn, as in an unweighted GridGraph
+    bool weighted() const {
+        return false;
+    }
+
+    // Call visit(destination, 1) for the 4 neighbours of a cell that is not a wall,
+    // in the order of GridGraph::forEachNeighbor: next line, right, left, previous line
+    template <typename Visit>
+    void forEachNeighbor(int cell, Visit visit) const {
+        int line = (cell >> TileShift) & (TileSide - 1), column = cell & (TileSide - 1);
+        visit(line != TileSide - 1 ? cell + TileSide : cell + lineStride - (TileCells - TileSide), 1.0);
+        visit(column != TileSide - 1 ? cell + 1 : cell + TileCells - (TileSide - 1), 1.0);
+        visit(column != 0 ? cell - 1 : cell - TileCells + (TileSide - 1), 1.0);
+        visit(line != 0 ? cell - TileSide : cell - lineStride + (TileCells - TileSide), 1.0);
+    }
+
+private:
+    int tilesPerLine = 0; // Number of tiles across the padded grid
+    int lineStride = 0; // Cells of a line of tiles
+};
+
+#endif //LABYRINTH_TILEDGRID_H
@@ -1,5 +1,6 @@
 #include <limits> // Include the limits header for numeric limits
 #include "WeightedGraph.h" // Include the declaration of the WeightedGraph class
+#include "Terrain.h" // Include the costs of the terrain symbols
 
 // Edge class constructor
 WeightedGraph::Edge::Edge(int source, int destination, double weight)
@@ -34,3 +35,91 @@ void WeightedGraph::Graph::addEdge(int source, int destination, double weight) {
     Edge edge(source, destination, weight);
     vertexList[source].addNeighbor(edge);
 }
+
+void WeightedGraph::Graph::reset(int lines, int rows) {
+    // Keep the vertex objects of the previous grid, only new vertices are constructed
+    int numberV = lines * rows;
+    if (vertexList.size() > static_cast<size_t>(numberV))
+        vertexList.erase(vertexList.begin() + numberV, vertexList.end());
+    vertexList.reserve(numberV);
+    while (vertexList.size() < static_cast<size_t>(numberV))
+        vertexList.emplace_back(0, '.', 0, 0);
+    num_v = numberV;
+
+    Edge neighbors[4] = {Edge(0, 0, 1), Edge(0, 0, 1), Edge(0, 0, 1), Edge(0, 0, 1)};
+    for (int v = 0; v < numberV; v++) {
+        Vertex& vertex = vertexList[v];
+        vertex.num = v;
+        vertex.label = '.';
+        vertex.i = v / rows;
+        vertex.j = v % rows;
+        vertex.indivTime = 1;
+        vertex.timeFromSource = std::numeric_limits<double>::infinity();
+        vertex.heuristic = -1;
+        vertex.prev = nullptr;
+
+        // Same order as the lists built by addEdge, assign reuses the existing list nodes
+        int count = 0;
+        if (v + rows < numberV)
+            neighbors[count++] = Edge(v, v + rows, 1); // Cell on the next line
+        if (vertex.j != rows - 1)
+            neighbors[count++] = Edge(v, v + 1, 1); // Cell on the right
+        if (vertex.j != 0)
+            neighbors[count++] = Edge(v, v - 1, 1); // Cell on the left
+        if (v >= rows)
+            neighbors[count++] = Edge(v, v - rows, 1); // Cell on the previous line
+        vertex.adjacencyList.assign(neighbors, neighbors + count);
+    }
+}
+
+// GridGraph class constructors
+WeightedGraph::GridGraph::GridGraph() = default;
+
+WeightedGraph::GridGraph::GridGraph(int lines, int rows)
+        : labels(static_cast<size_t>(lines) * rows, '.'), lines(lines), rows(rows) {}
+
+WeightedGraph::GridGraph::GridGraph(const Graph& graph, int lines, int rows) : lines(lines), rows(rows) {
+    // Copy the labels and flatten the adjacency lists into CSR arrays
+    labels.reserve(graph.vertexList.size());
+    edgeOffsets.reserve(graph.vertexList.size() + 1);
+    edgeOffsets.push_back(0);
+    for (const Vertex& vertex : graph.vertexList) {
+        labels.push_back(vertex.label);
+        for (const Edge& edge : vertex.adjacencyList) {
+            edgeTargets.push_back(edge.destination);
+            edgeWeights.push_back(edge.weight * graph.vertexList[edge.destination].indivTime);
+        }
+        edgeOffsets.push_back(static_cast<int>(edgeTargets.size()));
+    }
+}
+
+void WeightedGraph::GridGraph::reset(int lines, int rows) {
+    // Every cell open and no explicit adjacency, the capacity of the vectors is kept
+    this->lines = lines;
+    this->rows = rows;
+    labels.assign(static_cast<size_t>(lines) * rows, '.');
+    edgeOffsets.clear();
+    edgeTargets.clear();
+    edgeWeights.clear();
+    costs.clear();
+    fireDelays.clear();
+}
+
+bool WeightedGraph::GridGraph::setCell(int cell, char symbol) {
+    // Plain cells leave the cost arrays alone, they are only allocated by the first slower cell
+    int cost = 1, delay = 1;
+    if (!Terrain::lookup(symbol, cost, delay)) {
+        labels[cell] = symbol;
+        return symbol == '#' || symbol == 'D' || symbol == 'F' || symbol == 'S';
+    }
+    labels[cell] = '.';
+    if (cost == 1 && delay == 1 && costs.empty())
+        return true;
+    if (costs.empty()) {
+        costs.assign(labels.size(), 1);
+        fireDelays.assign(labels.size(), 1);
+    }
+    costs[cell] = static_cast<uint8_t>(cost);
+    fireDelays[cell] = static_cast<uint8_t>(delay);
+    return true;
+}
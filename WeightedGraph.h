@@ -1,6 +1,7 @@
 #ifndef LABYRINTH_WEIGHTEDGRAPH_H
 #define LABYRINTH_WEIGHTEDGRAPH_H
 
+#include <cstdint> // Fixed width integers
 #include <iostream> // Input/output stream functionality
 #include <vector> // Dynamic array functionality using vectors
 #include <list> // Linked list functionality
@@ -48,12 +49,80 @@ public:
         // Graph constructor
         Graph();
 
+        // Refill the graph in place with a grid of lines * rows open cells and their 4-neighbour edges
+        // The vertices and the nodes of the adjacency lists of the previous grid are reused
+        void reset(int lines, int rows);
+
         // Method to add a vertex to the graph
         void addVertex(char label, double indivTime, int i, int j);
 
         // Method to add a weighted edge between two vertices
         void addEdge(int source, int destination, double weight);
     };
+
+    // Compact graph for grid labyrinths: one label byte per cell, the 4 neighbours of a cell are derived from its number
+    // A CSR adjacency can be attached for non-grid graphs, it then replaces the implicit neighbours
+    class GridGraph {
+    public:
+        std::vector<char> labels; // Cell labels in row-major order, cell number = i * rows + j
+        std::vector<int> edgeOffsets; // CSR offsets of the edges of each vertex, empty for an implicit grid
+        std::vector<int> edgeTargets; // CSR destinations of the edges
+        std::vector<double> edgeWeights; // CSR weights of the edges
+        std::vector<uint8_t> costs; // Turns to cross each cell (Terrain), empty when every cell takes one turn
+        std::vector<uint8_t> fireDelays; // Turns the fire takes to enter each cell, filled together with costs
+        int lines = 0; // Number of lines of the grid
+        int rows = 0; // Number of cells per line
+
+        // GridGraph constructors, an empty grid or a grid of lines * rows open cells
+        GridGraph();
+        GridGraph(int lines, int rows);
+
+        // Build a compact copy of a general graph, its labels and its edges as CSR adjacency
+        // The weight of an edge is multiplied by the individual time of its destination
+        GridGraph(const Graph& graph, int lines, int rows);
+
+        // Refill the grid in place with lines * rows open cells, the memory of the previous grid is reused
+        void reset(int lines, int rows);
+
+        // Store a symbol of the input in a cell: terrain symbols become '.' with their costs, '#', 'D', 'F' and 'S' are copied
+        // Return false for any other symbol, which is copied as it is and must not be decided
+        bool setCell(int cell, char symbol);
+
+        // Check if some cell takes more than one turn to cross or to burn
+        bool weighted() const {
+            return !costs.empty();
+        }
+
+        // Turns to cross a cell
+        int costOf(int cell) const {
+            return costs.empty() ? 1 : costs[cell];
+        }
+
+        // Number of vertices in the graph
+        int size() const {
+            return static_cast<int>(labels.size());
+        }
+
+        // Call visit(destination, weight) for every edge leaving the vertex, the weight of a grid move is the cost of its destination
+        template <typename Visit>
+        void forEachNeighbor(int vertexNum, Visit visit) const {
+            if (!edgeOffsets.empty()) {
+                for (int e = edgeOffsets[vertexNum]; e < edgeOffsets[vertexNum + 1]; e++)
+                    visit(edgeTargets[e], edgeWeights[e]);
+                return;
+            }
+            // Same order as the adjacency lists built by addEdge, so ties are broken the same way
+            int j = vertexNum % rows;
+            if (vertexNum + rows < size())
+                visit(vertexNum + rows, costOf(vertexNum + rows)); // Cell on the next line
+            if (j != rows - 1)
+                visit(vertexNum + 1, costOf(vertexNum + 1)); // Cell on the right
+            if (j != 0)
+                visit(vertexNum - 1, costOf(vertexNum - 1)); // Cell on the left
+            if (vertexNum >= rows)
+                visit(vertexNum - rows, costOf(vertexNum - rows)); // Cell on the previous line
+        }
+    };
 };
 
 #endif //LABYRINTH_WEIGHTEDGRAPH_H
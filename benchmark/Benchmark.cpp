@@ -0,0 +1,412 @@
+#include "MazeGenerator.h" // Include the declaration of the MazeGenerator class
+#include "../Labyrinth.h" // Include the declaration of the Labyrinth class
+#include <algorithm> // Sorting the samples
+#include <chrono> // Timing of the phases
+#include <cstdio> // Output of the results
+#include <cstdlib> // Conversion of the arguments
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+#include <sys/resource.h> // Peak resident set size
+#ifdef __linux__
+#include <cstring> // Clearing the attributes of the counters
+#include <linux/perf_event.h> // Hardware cache and TLB miss counters
+#include <sys/syscall.h> // System call opening the counters
+#include <unistd.h> // Reading and closing the counters
+#endif
+
+namespace {
+    // Timings of the repetitions of one phase
+    struct Timing {
+        long long minimum = 0; // Fastest repetition in nanoseconds
+        long long median = 0; // Median repetition in nanoseconds
+        long long cacheMisses = -1; // Last level cache misses per repetition, -1 when the counters are not available
+        long long tlbMisses = -1; // Data TLB load misses per repetition, -1 when the counters are not available
+    };
+
+    // Hardware counters of the cache and TLB misses of this thread, through perf_event_open on Linux
+    // Virtual machines and restricted kernels often refuse them, the misses are then reported as -1
+    class MissCounters {
+    public:
+        MissCounters() {
+#ifdef __linux__
+            cache = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            tlb = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                               | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+#endif
+        }
+        MissCounters(const MissCounters&) = delete;
+        MissCounters& operator=(const MissCounters&) = delete;
+        ~MissCounters() {
+#ifdef __linux__
+            if (cache >= 0)
+                close(cache);
+            if (tlb >= 0)
+                close(tlb);
+#endif
+        }
+
+        // Current counts, -1 for a counter that could not be opened
+        long long cacheMisses() const {
+            return readCounter(cache);
+        }
+        long long tlbMisses() const {
+            return readCounter(tlb);
+        }
+
+    private:
+        int cache = -1; // Descriptor of the cache miss counter
+        int tlb = -1; // Descriptor of the TLB miss counter
+
+#ifdef __linux__
+        static int openCounter(uint32_t type, uint64_t config) {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.size = sizeof(attributes);
+            attributes.type = type;
+            attributes.config = config;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+#endif
+
+        static long long readCounter(int fd) {
+#ifdef __linux__
+            long long count = 0;
+            if (fd >= 0 && read(fd, &count, sizeof(count)) == static_cast<ssize_t>(sizeof(count)))
+                return count;
+#else
+            (void) fd;
+#endif
+            return -1;
+        }
+    };
+
+    // Run a phase the given number of times, result receives what the last repetition returned
+    template <typename Phase>
+    Timing measure(int repeats, Phase phase, std::string& result) {
+        static MissCounters counters;
+        std::vector<long long> samples;
+        long long cacheBefore = counters.cacheMisses(), tlbBefore = counters.tlbMisses();
+        for (int r = 0; r < repeats; r++) {
+            auto start = std::chrono::steady_clock::now();
+            result = phase();
+            auto end = std::chrono::steady_clock::now();
+            samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+        }
+        long long cacheAfter = counters.cacheMisses(), tlbAfter = counters.tlbMisses();
+        std::sort(samples.begin(), samples.end());
+        Timing timing;
+        timing.minimum = samples.front();
+        timing.median = samples[samples.size() / 2];
+        if (cacheBefore >= 0)
+            timing.cacheMisses = (cacheAfter - cacheBefore) / repeats;
+        if (tlbBefore >= 0)
+            timing.tlbMisses = (tlbAfter - tlbBefore) / repeats;
+        return timing;
+    }
+
+    // Peak resident set size of the process so far, in kilobytes
+    long peakRss() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_maxrss;
+    }
+
+    // Writer of the result lines in CSV or JSON
+    class Report {
+    public:
+        explicit Report(bool json) : json(json) {}
+
+        void begin() {
+            if (json)
+                std::printf("[\n");
+            else
+                std::printf("maze,lines,rows,cells,phase,repeats,median_ns,min_ns,cells_per_second,cache_misses,tlb_misses,"
+                            "result,peak_rss_kb\n");
+        }
+
+        void add(const std::string& maze, const Maze& grid, const std::string& phase, int repeats,
+                 const Timing& timing, const std::string& result) {
+            long long cells = static_cast<long long>(grid.lines) * grid.rows;
+            double perSecond = timing.median > 0 ? cells * 1e9 / static_cast<double>(timing.median) : 0;
+            if (json) {
+                std::printf("%s  {\"maze\": \"%s\", \"lines\": %d, \"rows\": %d, \"cells\": %lld, \"phase\": \"%s\", "
+                            "\"repeats\": %d, \"median_ns\": %lld, \"min_ns\": %lld, \"cells_per_second\": %.0f, "
+                            "\"cache_misses\": %lld, \"tlb_misses\": %lld, \"result\": \"%s\", \"peak_rss_kb\": %ld}",
+                            lines++ > 0 ? ",\n" : "", maze.c_str(), grid.lines, grid.rows, cells, phase.c_str(), repeats,
+                            timing.median, timing.minimum, perSecond, timing.cacheMisses, timing.tlbMisses, result.c_str(),
+                            peakRss());
+            } else {
+                std::printf("%s,%d,%d,%lld,%s,%d,%lld,%lld,%.0f,%lld,%lld,%s,%ld\n", maze.c_str(), grid.lines, grid.rows,
+                            cells, phase.c_str(), repeats, timing.median, timing.minimum, perSecond, timing.cacheMisses,
+                            timing.tlbMisses, result.c_str(), peakRss());
+            }
+            std::fflush(stdout);
+        }
+
+        void end() {
+            if (json)
+                std::printf("\n]\n");
+        }
+
+    private:
+        bool json; // JSON array instead of CSV
+        int lines = 0; // Number of results written
+    };
+
+    // Fill a general graph and a compact grid with the labels of a maze
+    void fill(const Maze& maze, Labyrinth::Graph& graph) {
+        graph.reset(maze.lines, maze.rows);
+        for (size_t v = 0; v < maze.labels.size(); v++)
+            graph.vertexList[v].label = maze.labels[v];
+    }
+    void fill(const Maze& maze, Labyrinth::GridGraph& grid) {
+        grid.reset(maze.lines, maze.rows);
+        grid.labels = maze.labels;
+    }
+
+    // Time the fire step and the escape decision on the row-major grid and on its tiled copy
+    void runLayouts(Report& report, const std::string& name, const Maze& maze, const Labyrinth::GridGraph& grid,
+                    Labyrinth::SearchBuffers& buffers, int repeats) {
+        std::string result;
+        TiledGrid tiled;
+        report.add(name, maze, "tile-build", repeats, measure(repeats, [&] {
+            tiled.assign(grid);
+            return std::to_string(tiled.size());
+        }, result), result);
+        report.add(name, maze, "fireArrivalTimes", repeats, measure(repeats, [&] {
+            Labyrinth::fireArrivalTimes(grid, buffers);
+            return std::to_string(buffers.ignition[maze.end]);
+        }, result), result);
+        report.add(name, maze, "fireArrivalTimes-tiled", repeats, measure(repeats, [&] {
+            Labyrinth::fireArrivalTimes(tiled, buffers);
+            return std::to_string(buffers.ignition[tiled.cellOf(maze.end)]);
+        }, result), result);
+        report.add(name, maze, "escapeDecision", repeats, measure(repeats, [&] {
+            return std::string(1, Labyrinth::escapeDecision(grid, maze.start, maze.end, buffers));
+        }, result), result);
+        report.add(name, maze, "escapeDecision-tiled", repeats, measure(repeats, [&] {
+            return std::string(1, Labyrinth::escapeDecision(tiled, maze.start, maze.end, buffers));
+        }, result), result);
+    }
+
+    // Time every phase on one maze
+    void run(Report& report, const std::string& name, const Maze& maze, int repeats, long long graphCells,
+             long long simulationCells) {
+        long long cells = static_cast<long long>(maze.lines) * maze.rows;
+        std::string result;
+        Labyrinth::SearchBuffers buffers;
+
+        // Construction of both representations from nothing
+        report.add(name, maze, "graph-build", repeats, measure(repeats, [&] {
+            Labyrinth::Graph graph;
+            fill(maze, graph);
+            return std::to_string(graph.num_v);
+        }, result), result);
+        report.add(name, maze, "grid-build", repeats, measure(repeats, [&] {
+            Labyrinth::GridGraph grid;
+            fill(maze, grid);
+            return std::to_string(grid.size());
+        }, result), result);
+
+        // Path searches on the general graph, its memory grows quickly with the size
+        if (cells <= graphCells) {
+            Labyrinth::Graph graph;
+            fill(maze, graph);
+            report.add(name, maze, "dijkstra-graph", repeats, measure(repeats, [&] {
+                return std::to_string(Labyrinth::Dijkstra(graph, maze.start, maze.end, maze.rows).steps());
+            }, result), result);
+            report.add(name, maze, "astar-graph", repeats, measure(repeats, [&] {
+                return std::to_string(Labyrinth::AStar(graph, maze.start, maze.end, maze.rows, maze.lines * maze.rows).steps());
+            }, result), result);
+        }
+
+        // Path searches and decisions on the compact grid
+        Labyrinth::GridGraph grid;
+        fill(maze, grid);
+        report.add(name, maze, "dijkstra", repeats, measure(repeats, [&] {
+            return std::to_string(Labyrinth::Dijkstra(grid, maze.start, maze.end, buffers).steps());
+        }, result), result);
+        report.add(name, maze, "astar", repeats, measure(repeats, [&] {
+            return std::to_string(Labyrinth::AStar(grid, maze.start, maze.end, buffers).steps());
+        }, result), result);
+
+        // The specialised solvers against the same search with real weights on a heap, so each line shows what
+        // the breadth-first order or the bucket queue gains. Terrain weights 1 to 9 are derived from the cell numbers
+        std::vector<uint8_t> terrain(static_cast<size_t>(cells));
+        std::vector<double> unitWeights(static_cast<size_t>(cells), 1.0), terrainWeights(static_cast<size_t>(cells));
+        for (size_t v = 0; v < terrain.size(); v++) {
+            terrain[v] = static_cast<uint8_t>(1 + (static_cast<uint32_t>(v) * 2654435761u >> 16) % 9);
+            terrainWeights[v] = terrain[v];
+        }
+        GridSolver<FourConnected, UnitCost> fourUnit;
+        GridSolver<FourConnected, SmallIntegerCost> fourSmall;
+        GridSolver<FourConnected, RealCost> fourReal;
+        GridSolver<EightConnected, UnitCost> eightUnit;
+        GridSolver<EightConnected, RealCost> eightReal;
+        PathResult path;
+        report.add(name, maze, "solver-4-unit", repeats, measure(repeats, [&] {
+            fourUnit.shortestPath(grid.labels, grid.lines, grid.rows, maze.start, maze.end, UnitCost(), path);
+            return std::to_string(path.steps());
+        }, result), result);
+        report.add(name, maze, "solver-4-unit-as-real", repeats, measure(repeats, [&] {
+            fourReal.shortestPath(grid.labels, grid.lines, grid.rows, maze.start, maze.end, RealCost{unitWeights.data()}, path);
+            return std::to_string(path.steps());
+        }, result), result);
+        report.add(name, maze, "solver-4-small", repeats, measure(repeats, [&] {
+            fourSmall.shortestPath(grid.labels, grid.lines, grid.rows, maze.start, maze.end,
+                                   SmallIntegerCost{terrain.data(), 9}, path);
+            return std::to_string(path.empty() ? -1 : fourSmall.distanceTo(maze.end));
+        }, result), result);
+        report.add(name, maze, "solver-4-small-as-real", repeats, measure(repeats, [&] {
+            fourReal.shortestPath(grid.labels, grid.lines, grid.rows, maze.start, maze.end,
+                                  RealCost{terrainWeights.data()}, path);
+            return std::to_string(path.empty() ? -1 : static_cast<long long>(fourReal.distanceTo(maze.end)));
+        }, result), result);
+        report.add(name, maze, "solver-8-unit", repeats, measure(repeats, [&] {
+            eightUnit.shortestPath(grid.labels, grid.lines, grid.rows, maze.start, maze.end, UnitCost(), path);
+            return std::to_string(path.steps());
+        }, result), result);
+        report.add(name, maze, "solver-8-unit-as-real", repeats, measure(repeats, [&] {
+            eightReal.shortestPath(grid.labels, grid.lines, grid.rows, maze.start, maze.end, RealCost{unitWeights.data()}, path);
+            return std::to_string(path.steps());
+        }, result), result);
+        // The same maze with the terrain weights as digits: A* and the escape decision then run on costs and fire delays
+        Labyrinth::GridGraph terrainGrid;
+        fill(maze, terrainGrid);
+        for (int v = 0; v < terrainGrid.size(); v++)
+            if (terrainGrid.labels[v] == '.')
+                terrainGrid.setCell(v, static_cast<char>('0' + terrain[static_cast<size_t>(v)]));
+        report.add(name, maze, "astar-terrain", repeats, measure(repeats, [&] {
+            return std::to_string(Labyrinth::AStar(terrainGrid, maze.start, maze.end, buffers).steps());
+        }, result), result);
+        report.add(name, maze, "escapeDecision-terrain", repeats, measure(repeats, [&] {
+            return std::string(1, Labyrinth::escapeDecision(terrainGrid, maze.start, maze.end, buffers));
+        }, result), result);
+        report.add(name, maze, "jps", repeats, measure(repeats, [&] {
+            return std::to_string(Labyrinth::JumpPointSearch(grid, maze.start, maze.end, buffers).steps());
+        }, result), result);
+        report.add(name, maze, "bidirectional", repeats, measure(repeats, [&] {
+            return std::to_string(Labyrinth::BidirectionalSearch(grid, maze.start, maze.end, buffers).steps());
+        }, result), result);
+
+        // The cluster abstraction is built once, then each search only crosses the abstract graph and refines its path
+        HierarchicalPlanner& hierarchy = buffers.hierarchy;
+        report.add(name, maze, "hierarchical-build", repeats, measure(repeats, [&] {
+            hierarchy.build(grid.labels, grid.lines, grid.rows);
+            return std::to_string(hierarchy.nodeCount());
+        }, result), result);
+        report.add(name, maze, "hierarchical", repeats, measure(repeats, [&] {
+            return std::to_string(Labyrinth::HierarchicalSearch(grid, maze.start, maze.end, buffers).steps());
+        }, result), result);
+        runLayouts(report, name, maze, grid, buffers, repeats);
+        report.add(name, maze, "escapeDecision-bidirectional", repeats, measure(repeats, [&] {
+            return std::string(1, Labyrinth::bidirectionalEscapeDecision(grid, maze.start, maze.end, buffers));
+        }, result), result);
+
+        // The replanning simulation only touches the burning front and the repaired region each turn
+        report.add(name, maze, "runInstance-replanning", repeats, measure(repeats, [&] {
+            return std::string(1, Labyrinth::runInstance(grid, maze.start, maze.end, buffers, Labyrinth::FireKernel::Fronts,
+                                                         Labyrinth::PathSearch::Incremental));
+        }, result), result);
+
+        // The fronts kernel only touches the cells that ignite each turn
+        report.add(name, maze, "runInstance", repeats, measure(repeats, [&] {
+            return std::string(1, Labyrinth::runInstance(grid, maze.start, maze.end, buffers));
+        }, result), result);
+
+        // The labels and bitboard kernels scan the whole grid every turn
+        if (cells <= simulationCells) {
+            report.add(name, maze, "runInstance-labels", repeats, measure(repeats, [&] {
+                return std::string(1, Labyrinth::runInstance(grid, maze.start, maze.end, buffers,
+                                                             Labyrinth::FireKernel::Labels));
+            }, result), result);
+            report.add(name, maze, "runInstance-bitboard", repeats, measure(repeats, [&] {
+                return std::string(1, Labyrinth::runInstance(grid, maze.start, maze.end, buffers,
+                                                             Labyrinth::FireKernel::Bitboard));
+            }, result), result);
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // --format csv|json, --max N largest side, --repeat R repetitions per phase, --seed S of the generators
+    // --graph-cells and --simulation-cells bound the sizes of the slow phases
+    // --wide M also compares the row-major and tiled layouts on mazes of --max lines and M cells per line
+    bool json = false;
+    int maxSide = 1000, repeats = 5, wideRows = 0;
+    uint32_t seed = 1;
+    long long graphCells = 1000000, simulationCells = 100000;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            json = std::string(argv[++i]) == "json";
+        } else if (arg == "--max" && i + 1 < argc) {
+            maxSide = std::atoi(argv[++i]);
+        } else if (arg == "--repeat" && i + 1 < argc) {
+            repeats = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--graph-cells" && i + 1 < argc) {
+            graphCells = std::atoll(argv[++i]);
+        } else if (arg == "--simulation-cells" && i + 1 < argc) {
+            simulationCells = std::atoll(argv[++i]);
+        } else if (arg == "--wide" && i + 1 < argc) {
+            wideRows = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage : %s [--format csv|json] [--max N] [--repeat R] [--seed S] "
+                                 "[--graph-cells C] [--simulation-cells C] [--wide M]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (maxSide < 10 || repeats < 1 || (wideRows != 0 && wideRows < 10)) {
+        std::fprintf(stderr, "Error : --max and --wide must be at least 10 and --repeat at least 1.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Square mazes from 10x10 up to the largest side, about sqrt(10) apart
+    std::vector<int> sides;
+    for (double side = 10; side < maxSide; side *= 3.1622776601683795)
+        sides.push_back(static_cast<int>(side + 0.5));
+    sides.push_back(maxSide);
+
+    struct Shape {
+        MazeGenerator::Kind kind;
+        int density;
+    };
+    const Shape shapes[] = {
+        {MazeGenerator::OpenField, 0},
+        {MazeGenerator::RandomWalls, 10},
+        {MazeGenerator::RandomWalls, 20},
+        {MazeGenerator::RandomWalls, 30},
+        {MazeGenerator::RandomWalls, 40},
+        {MazeGenerator::PerfectDfs, 0},
+        {MazeGenerator::PerfectPrim, 0},
+        {MazeGenerator::Spiral, 0},
+        {MazeGenerator::FireNextToPrisoner, 0},
+    };
+
+    MazeGenerator generator(seed);
+    Report report(json);
+    report.begin();
+    for (int side : sides) {
+        for (const Shape& shape : shapes) {
+            Maze maze = generator.generate(shape.kind, side, side, shape.density);
+            run(report, MazeGenerator::name(shape.kind, shape.density), maze, repeats, graphCells, simulationCells);
+        }
+    }
+
+    // Wide mazes, where a move to the next line crosses a whole line of row-major cells: only the layouts are compared
+    if (wideRows != 0) {
+        Labyrinth::SearchBuffers buffers;
+        for (const Shape& shape : shapes) {
+            Maze maze = generator.generate(shape.kind, maxSide, wideRows, shape.density);
+            Labyrinth::GridGraph grid;
+            fill(maze, grid);
+            runLayouts(report, MazeGenerator::name(shape.kind, shape.density), maze, grid, buffers, repeats);
+        }
+    }
+    report.end();
+    return EXIT_SUCCESS;
+}
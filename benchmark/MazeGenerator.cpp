@@ -0,0 +1,184 @@
+#include "MazeGenerator.h" // Include the declaration of the MazeGenerator class
+#include <random> // Seeded pseudo-random generator
+
+MazeGenerator::MazeGenerator(uint32_t seed) : seed(seed) {}
+
+std::string MazeGenerator::name(Kind kind, int density) {
+    switch (kind) {
+        case OpenField:
+            return "open";
+        case RandomWalls:
+            return "walls-" + std::to_string(density);
+        case PerfectDfs:
+            return "dfs";
+        case PerfectPrim:
+            return "prim";
+        case Spiral:
+            return "spiral";
+        case FireNextToPrisoner:
+            return "fire-adjacent";
+    }
+    return "unknown";
+}
+
+Maze MazeGenerator::generate(Kind kind, int lines, int rows, int density) {
+    Maze maze;
+    maze.lines = lines;
+    maze.rows = rows;
+    std::mt19937 random(seed ^ (static_cast<uint32_t>(kind) * 0x9e3779b9u) ^ (static_cast<uint32_t>(lines) << 16)
+                        ^ static_cast<uint32_t>(rows) ^ (static_cast<uint32_t>(density) << 24));
+    int numberV = lines * rows;
+
+    switch (kind) {
+        case OpenField:
+            maze.labels.assign(numberV, '.');
+            place(maze, 0, numberV - 1, (lines - 1) * rows);
+            break;
+
+        case RandomWalls:
+        case FireNextToPrisoner: {
+            if (kind == FireNextToPrisoner)
+                density = 20;
+            maze.labels.resize(numberV);
+            for (char& label : maze.labels)
+                label = static_cast<int>(random() % 100) < density ? '#' : '.';
+            if (kind == RandomWalls) {
+                int start = static_cast<int>(random() % numberV), end, fire;
+                do end = static_cast<int>(random() % numberV); while (end == start);
+                do fire = static_cast<int>(random() % numberV); while (fire == start || fire == end);
+                place(maze, start, end, fire);
+            } else {
+                // Prisoner in the middle, fire on its right, exit in the far corner
+                int start = (lines / 2) * rows + rows / 2;
+                place(maze, start, numberV - 1, start + 1);
+            }
+            break;
+        }
+
+        case PerfectDfs:
+        case PerfectPrim: {
+            maze.labels.assign(numberV, '#');
+            if (kind == PerfectDfs)
+                carveDfs(maze, static_cast<uint32_t>(random()));
+            else
+                carvePrim(maze, static_cast<uint32_t>(random()));
+            // D and S in opposite corners of the grid of even cells, F on a cell of odd coordinates,
+            // which is never a passage, so the fire cannot cut the only path
+            int lastLine = (lines - 1) & ~1, lastRow = (rows - 1) & ~1;
+            place(maze, 0, lastLine * rows + lastRow, (lastLine - 1) * rows + 1);
+            break;
+        }
+
+        case Spiral: {
+            maze.labels.assign(numberV, '#');
+            carveSpiral(maze);
+            break;
+        }
+    }
+    return maze;
+}
+
+void MazeGenerator::carveDfs(Maze& maze, uint32_t seed) {
+    // Iterative backtracker on the cells of even coordinates, the cells in between are the passages
+    std::mt19937 random(seed);
+    int lines = maze.lines, rows = maze.rows;
+    const int moves[4][2] = {{-2, 0}, {2, 0}, {0, -2}, {0, 2}};
+    std::vector<int> stack(1, 0);
+    maze.labels[0] = '.';
+    while (!stack.empty()) {
+        int cell = stack.back();
+        int i = cell / rows, j = cell % rows;
+
+        // Unvisited neighbours two cells away
+        int candidates[4], count = 0;
+        for (int d = 0; d < 4; d++) {
+            int ni = i + moves[d][0], nj = j + moves[d][1];
+            if (ni >= 0 && ni < lines && nj >= 0 && nj < rows && maze.labels[ni * rows + nj] == '#')
+                candidates[count++] = d;
+        }
+        if (count == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        int d = candidates[random() % count];
+        int ni = i + moves[d][0], nj = j + moves[d][1];
+        maze.labels[(i + moves[d][0] / 2) * rows + j + moves[d][1] / 2] = '.';
+        maze.labels[ni * rows + nj] = '.';
+        stack.push_back(ni * rows + nj);
+    }
+}
+
+void MazeGenerator::carvePrim(Maze& maze, uint32_t seed) {
+    // Randomized Prim: open a random wall between the maze and a cell of even coordinates outside it
+    std::mt19937 random(seed);
+    int lines = maze.lines, rows = maze.rows;
+    const int moves[4][2] = {{-2, 0}, {2, 0}, {0, -2}, {0, 2}};
+    std::vector<int> frontier; // Pairs (cell outside the maze, cell inside)
+    auto addFrontier = [&](int cell) {
+        int i = cell / rows, j = cell % rows;
+        for (const auto& move : moves) {
+            int ni = i + move[0], nj = j + move[1];
+            if (ni >= 0 && ni < lines && nj >= 0 && nj < rows && maze.labels[ni * rows + nj] == '#') {
+                frontier.push_back(ni * rows + nj);
+                frontier.push_back(cell);
+            }
+        }
+    };
+
+    maze.labels[0] = '.';
+    addFrontier(0);
+    while (!frontier.empty()) {
+        // Take a random pair, swap it with the last one and drop it
+        size_t pick = (random() % (frontier.size() / 2)) * 2;
+        int outside = frontier[pick], inside = frontier[pick + 1];
+        frontier[pick] = frontier[frontier.size() - 2];
+        frontier[pick + 1] = frontier[frontier.size() - 1];
+        frontier.resize(frontier.size() - 2);
+        if (maze.labels[outside] != '#')
+            continue;
+
+        maze.labels[(outside + inside) / 2] = '.';
+        maze.labels[outside] = '.';
+        addFrontier(outside);
+    }
+}
+
+void MazeGenerator::carveSpiral(Maze& maze) {
+    // Walk inwards from the top left corner, turning clockwise when the corridor would touch itself
+    int lines = maze.lines, rows = maze.rows;
+    const int moves[4][2] = {{0, 1}, {1, 0}, {0, -1}, {-1, 0}};
+    auto open = [&](int i, int j) {
+        return i >= 0 && i < lines && j >= 0 && j < rows && maze.labels[i * rows + j] == '.';
+    };
+    auto inside = [&](int i, int j) {
+        return i >= 0 && i < lines && j >= 0 && j < rows;
+    };
+
+    int i = 0, j = 0, d = 0, turns = 0;
+    maze.labels[0] = '.';
+    while (turns < 2) {
+        int ni = i + moves[d][0], nj = j + moves[d][1];
+        if (inside(ni, nj) && !open(ni, nj) && !open(ni + moves[d][0], nj + moves[d][1])) {
+            i = ni;
+            j = nj;
+            maze.labels[i * rows + j] = '.';
+            turns = 0;
+        } else {
+            d = (d + 1) % 4;
+            turns++;
+        }
+    }
+
+    // Prisoner at the entrance, exit at the centre, fire in the wall between the first two laps
+    place(maze, 0, i * rows + j, rows + rows / 2);
+}
+
+void MazeGenerator::place(Maze& maze, int start, int end, int fire) {
+    maze.start = start;
+    maze.end = end;
+    maze.fire = fire;
+    maze.labels[start] = 'D';
+    maze.labels[end] = 'S';
+    maze.labels[fire] = 'F';
+}
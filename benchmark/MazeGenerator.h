@@ -0,0 +1,52 @@
+#ifndef LABYRINTH_MAZEGENERATOR_H
+#define LABYRINTH_MAZEGENERATOR_H
+
+#include <cstdint> // Fixed width integers
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+
+// Labyrinth produced by a generator: row-major labels with one 'D', one 'F' and one 'S'
+struct Maze {
+    int lines = 0; // Number of lines of the grid
+    int rows = 0; // Number of cells per line
+    std::vector<char> labels; // Cell labels, cell number = i * rows + j
+    int start = 0; // Cell of the prisoner (D)
+    int end = 0; // Cell of the exit (S)
+    int fire = 0; // Cell of the fire (F)
+};
+
+// Deterministic maze generators for the benchmarks
+// Only the raw output of std::mt19937 is used, so a seed gives the same mazes on every platform
+class MazeGenerator {
+public:
+    // Shapes of maze
+    enum Kind {
+        OpenField, // No walls, D, S and F in three corners
+        RandomWalls, // Walls drawn independently with the given density (percent)
+        PerfectDfs, // Perfect maze carved by a depth-first backtracker
+        PerfectPrim, // Perfect maze grown by randomized Prim
+        Spiral, // Single corridor winding from the border to the centre
+        FireNextToPrisoner // Random walls with the fire right next to the prisoner
+    };
+
+    explicit MazeGenerator(uint32_t seed);
+
+    // Generate a maze of lines * rows cells, lines and rows must be at least 5
+    Maze generate(Kind kind, int lines, int rows, int density = 0);
+
+    // Name of a kind, with the density for random walls ("walls-30")
+    static std::string name(Kind kind, int density = 0);
+
+private:
+    uint32_t seed; // Seed of every maze, each maze restarts from it
+
+    // Carve the passages of a perfect maze on the cells of even coordinates
+    static void carveDfs(Maze& maze, uint32_t seed);
+    static void carvePrim(Maze& maze, uint32_t seed);
+    static void carveSpiral(Maze& maze);
+
+    // Place D, S and F on three distinct cells, they are opened when they were walls
+    static void place(Maze& maze, int start, int end, int fire);
+};
+
+#endif //LABYRINTH_MAZEGENERATOR_H
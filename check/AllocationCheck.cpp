@@ -0,0 +1,134 @@
+#include "../benchmark/MazeGenerator.h" // Include the declaration of the MazeGenerator class
+#include "../Labyrinth.h" // Include the declaration of the Labyrinth class
+#include "../BatchReader.h" // Include the declaration of the BatchReader class
+#include <atomic> // Allocation counter shared by every thread
+#include <cstdio> // Temporary input file and output of the summary
+#include <cstdlib> // Memory of the counting operator new
+#include <new> // Replaceable allocation functions
+#include <string> // String manipulation functions
+#include <unistd.h> // Rewinding the input file
+#include <vector> // Dynamic array functionality using vectors
+
+namespace {
+    std::atomic<long long> allocations{0}; // Calls of operator new since the start of the process
+}
+
+// Counting replacements of the global allocation functions, every new of the program goes through them
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size == 0 ? 1 : size))
+        return memory;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+namespace {
+    // Write a batch input to file: mazes of every generator shape and size, a second prisoner in every other maze
+    // so that escapeDecisions runs too, and a wide maze decided on the tiled copy
+    long long writeInstances(FILE* file) {
+        MazeGenerator generator(11);
+        std::vector<Maze> mazes;
+        const MazeGenerator::Kind kinds[] = {MazeGenerator::OpenField, MazeGenerator::RandomWalls, MazeGenerator::PerfectDfs,
+                                             MazeGenerator::PerfectPrim, MazeGenerator::Spiral,
+                                             MazeGenerator::FireNextToPrisoner};
+        for (int side : {5, 17, 64, 301}) {
+            for (MazeGenerator::Kind kind : kinds) {
+                mazes.push_back(generator.generate(kind, side, side + 3, 25));
+                if (mazes.size() % 2 == 0) {
+                    Maze& maze = mazes.back();
+                    for (size_t v = 0; v < maze.labels.size(); v++) {
+                        if (maze.labels[v] == '.') {
+                            maze.labels[v] = 'D';
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        mazes.push_back(generator.generate(MazeGenerator::RandomWalls, TiledGrid::MinimumCells / TiledGrid::MinimumRows,
+                                           TiledGrid::MinimumRows, 10));
+
+        std::fprintf(file, "%zu\n", mazes.size());
+        for (const Maze& maze : mazes) {
+            std::fprintf(file, "%d %d\n", maze.lines, maze.rows);
+            for (int i = 0; i < maze.lines; i++) {
+                std::fwrite(&maze.labels[static_cast<size_t>(i) * maze.rows], 1, static_cast<size_t>(maze.rows), file);
+                std::fputc('\n', file);
+            }
+        }
+        std::fflush(file);
+        return static_cast<long long>(mazes.size());
+    }
+
+    // State of the batch loop kept across passes, as main keeps it across instances
+    struct BatchState {
+        Labyrinth::GridGraph grid; // Labels of the instance
+        Labyrinth::SearchBuffers buffers; // Buffers of every search
+        std::string out; // Results waiting to be written
+        std::string result; // Results of the instance
+        std::string error; // Description of a malformed instance
+    };
+
+    // The serial loop of the batch mode on the instances below PackedGrid::MinimumCells: read, decide, queue, write in blocks
+    bool runBatch(BatchReader& reader, BatchState& state, FILE* output) {
+        long long instances = 0;
+        if (!reader.readInt(instances))
+            return false;
+        for (long long i = 0; i < instances; i++) {
+            int startV = 0, endV = 0;
+            long long n = 0, m = 0;
+            if (!reader.readDimensions(n, m, state.error) || !reader.readRows(state.grid, n, m, startV, endV, state.error))
+                return false;
+            Labyrinth::decideInstance(state.grid, reader.prisoners(), reader.exits(), startV, endV, state.buffers,
+                                      state.result);
+            state.out += state.result;
+            state.out += '\n';
+            if (state.out.size() >= (1 << 16)) {
+                std::fwrite(state.out.data(), 1, state.out.size(), output);
+                state.out.clear();
+            }
+        }
+        std::fwrite(state.out.data(), 1, state.out.size(), output);
+        state.out.clear();
+        return true;
+    }
+}
+
+int main() {
+    // The first pass sizes the reused memory, the second must not allocate
+    FILE* input = std::tmpfile();
+    FILE* output = std::fopen("/dev/null", "w");
+    if (input == nullptr || output == nullptr) {
+        std::fprintf(stderr, "Error : cannot open the temporary input or /dev/null.\n");
+        return EXIT_FAILURE;
+    }
+    long long instances = writeInstances(input);
+    BatchState state;
+    state.out.reserve(1 << 17);
+
+    long long counts[2];
+    for (int pass = 0; pass < 2; pass++) {
+        lseek(fileno(input), 0, SEEK_SET);
+        BatchReader reader(fileno(input));
+        long long before = allocations.load();
+        if (!runBatch(reader, state, output)) {
+            std::fprintf(stderr, "Error : %s\n", state.error.c_str());
+            return EXIT_FAILURE;
+        }
+        counts[pass] = allocations.load() - before;
+    }
+    std::fclose(input);
+    std::fclose(output);
+
+    std::printf("%-24s %8lld instances %6lld allocations on the first pass %6lld on the second\n", "batch-allocations",
+                instances, counts[0], counts[1]);
+    return counts[1] == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
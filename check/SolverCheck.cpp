@@ -0,0 +1,241 @@
+#include "../benchmark/MazeGenerator.h" // Include the declaration of the MazeGenerator class
+#include "../Labyrinth.h" // Include the declaration of the Labyrinth class
+#include <cmath> // Infinite times of the walls
+#include <cstdio> // Output of the summary
+#include <cstdlib> // Conversion of the arguments
+#include <random> // Dimensions of the mazes
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+
+namespace {
+    // Shapes of the checked mazes, those of the benchmark
+    struct Shape {
+        MazeGenerator::Kind kind;
+        int density;
+    };
+    const Shape shapes[] = {
+        {MazeGenerator::OpenField, 0},
+        {MazeGenerator::RandomWalls, 10},
+        {MazeGenerator::RandomWalls, 25},
+        {MazeGenerator::RandomWalls, 40},
+        {MazeGenerator::PerfectDfs, 0},
+        {MazeGenerator::PerfectPrim, 0},
+        {MazeGenerator::Spiral, 0},
+        {MazeGenerator::FireNextToPrisoner, 0},
+    };
+
+    // Result of one check
+    struct Outcome {
+        long long cases = 0; // Mazes or grids checked
+        long long mismatches = 0; // Cases where the two sides disagree
+    };
+
+    // Call check(name, maze) on mazes of every shape, count per shape, sides from 5 to maxSide drawn from seed
+    template <typename Check>
+    void forEachMaze(uint32_t seed, int count, int maxSide, Check check) {
+        std::mt19937 random(seed);
+        for (int k = 0; k < count; k++) {
+            MazeGenerator generator(static_cast<uint32_t>(random()));
+            for (const Shape& shape : shapes) {
+                int lines = 5 + static_cast<int>(random() % static_cast<uint32_t>(maxSide - 4));
+                int rows = 5 + static_cast<int>(random() % static_cast<uint32_t>(maxSide - 4));
+                Maze maze = generator.generate(shape.kind, lines, rows, shape.density);
+                check(MazeGenerator::name(shape.kind, shape.density), maze);
+            }
+        }
+    }
+
+    // Report a mismatch on the standard error
+    void reportMismatch(const char* check, const std::string& name, const Maze& maze, const std::string& detail) {
+        std::fprintf(stderr, "Mismatch : %s : %s %dx%d : %s\n", check, name.c_str(), maze.lines, maze.rows, detail.c_str());
+    }
+
+    // General graph of a maze: walls can never be entered, free cells take 1 to 9 turns derived from their number
+    void fill(const Maze& maze, Labyrinth::Graph& graph) {
+        graph.reset(maze.lines, maze.rows);
+        for (size_t v = 0; v < maze.labels.size(); v++) {
+            graph.vertexList[v].label = maze.labels[v];
+            graph.vertexList[v].indivTime = maze.labels[v] == '#' ? INFINITY
+                                                                   : 1 + (static_cast<uint32_t>(v) * 2654435761u >> 16) % 9;
+        }
+    }
+
+    // Dijkstra on the indexed heap against the reference scanning every vertex: same time to the exit,
+    // and the heap's path goes from the prisoner to the exit with that time
+    Outcome checkDijkstra(uint32_t seed, int count) {
+        Outcome outcome;
+        Labyrinth::Graph graph;
+        forEachMaze(seed, count, 24, [&](const std::string& name, const Maze& maze) {
+            outcome.cases++;
+            fill(maze, graph);
+            PathResult path = Labyrinth::Dijkstra(graph, maze.start, maze.end, maze.rows);
+            double heap = graph.vertexList[maze.end].timeFromSource;
+            double along = 0;
+            bool valid = !path.empty() && path.cells.front() == maze.start && path.cells.back() == maze.end;
+            for (size_t k = 1; valid && k < path.cells.size(); k++)
+                along += graph.vertexList[path.cells[k]].indivTime;
+
+            fill(maze, graph);
+            Labyrinth::DijkstraLinearScan(graph, maze.start, maze.end, maze.rows);
+            double scan = graph.vertexList[maze.end].timeFromSource;
+
+            if (heap != scan || (std::isfinite(heap) && (!valid || along != heap))) {
+                outcome.mismatches++;
+                reportMismatch("dijkstra", name, maze, "heap " + std::to_string(heap) + ", scan " + std::to_string(scan)
+                                                       + ", along the path " + std::to_string(along));
+            }
+        });
+        return outcome;
+    }
+
+    // Compact grid of a maze, every cell costs one turn
+    void fill(const Maze& maze, Labyrinth::GridGraph& grid) {
+        grid.reset(maze.lines, maze.rows);
+        grid.labels = maze.labels;
+    }
+
+    // escapeDecision against the turn by turn simulation. The simulation plays one route fixed up front, so it is an oracle
+    // in both directions only through routes: when the fire-unaware route of runInstance wins, escapeDecision must answer Y,
+    // and when escapeDecision answers Y, replaying its route turn by turn must win
+    Outcome checkEscape(uint32_t seed, int count) {
+        Outcome outcome;
+        Labyrinth::GridGraph grid;
+        Labyrinth::SearchBuffers buffers;
+        std::vector<int> route;
+        forEachMaze(seed, count, 24, [&](const std::string& name, const Maze& maze) {
+            outcome.cases++;
+            fill(maze, grid);
+            char decision = Labyrinth::escapeDecision(grid, maze.start, maze.end, buffers, &route);
+            char simulation = Labyrinth::runInstance(grid, maze.start, maze.end, buffers);
+            char replay = decision == 'Y' ? Labyrinth::replayInstance(grid, Labyrinth::movementDirections(route, maze.rows), buffers)
+                                          : 'N';
+            if ((simulation == 'Y' && decision != 'Y') || replay != decision) {
+                outcome.mismatches++;
+                reportMismatch("escape", name, maze, std::string("escapeDecision ") + decision + ", runInstance " + simulation
+                                                     + ", replay of the route " + replay);
+            }
+        });
+        return outcome;
+    }
+
+    // Decide a grid with decideInstance, its first prisoner toward its first exit, against escapeDecision toward each exit:
+    // the prisoner escapes when one of the exits is reached, a route through several exits stops at the first
+    bool decidesEveryExit(const Labyrinth::GridGraph& grid, Labyrinth::SearchBuffers& buffers, std::string& result,
+                          char& expected) {
+        int start = -1, end = -1;
+        long long exits = 0;
+        for (int v = 0; v < grid.size(); v++) {
+            if (grid.labels[v] == 'D' && start == -1)
+                start = v;
+            if (grid.labels[v] == 'S' && exits++ == 0)
+                end = v;
+        }
+        expected = 'N';
+        for (int v = 0; v < grid.size(); v++)
+            if (grid.labels[v] == 'S' && Labyrinth::escapeDecision(grid, start, v, buffers) == 'Y')
+                expected = 'Y';
+        Labyrinth::decideInstance(grid, 1, exits, start, end, buffers, result);
+        return result.size() == 1 && result[0] == expected;
+    }
+
+    // decideInstance on a single prisoner and several exits: the grid of the regression where the only reachable exit
+    // comes after the first one, then the generated mazes with a second exit on a free cell
+    Outcome checkExits(uint32_t seed, int count) {
+        Outcome outcome;
+        Labyrinth::GridGraph grid;
+        Labyrinth::SearchBuffers buffers;
+        std::string result;
+        char expected;
+
+        grid.reset(2, 5);
+        grid.labels.assign({'S', '#', 'D', '.', 'S', 'F', '#', '#', '#', '#'});
+        outcome.cases++;
+        if (!decidesEveryExit(grid, buffers, result, expected) || expected != 'Y') {
+            outcome.mismatches++;
+            std::fprintf(stderr, "Mismatch : exits : S#D.S/F#### : decideInstance %s, expected Y\n", result.c_str());
+        }
+
+        std::mt19937 random(seed);
+        forEachMaze(seed, count, 24, [&](const std::string& name, const Maze& maze) {
+            fill(maze, grid);
+            int cell = static_cast<int>(random() % maze.labels.size());
+            if (grid.labels[cell] != '.')
+                return;
+            grid.labels[cell] = 'S';
+            outcome.cases++;
+            if (!decidesEveryExit(grid, buffers, result, expected)) {
+                outcome.mismatches++;
+                reportMismatch("exits", name, maze, "decideInstance " + result + ", escapeDecision toward one of the exits "
+                                                    + expected + ", second exit " + std::to_string(cell));
+            }
+        });
+        return outcome;
+    }
+
+    // HierarchicalSearch with the same buffers on every maze, so that mazes of the same dimensions follow each other:
+    // the path must exist exactly when BreadthFirstSearch finds one, step between neighbours on free cells
+    // and be no shorter than the breadth-first path
+    Outcome checkHierarchy(uint32_t seed, int count) {
+        Outcome outcome;
+        Labyrinth::GridGraph grid;
+        Labyrinth::SearchBuffers buffers;
+        std::vector<int> cells;
+        for (int k = 0; k < count; k++) {
+            MazeGenerator generator(seed + static_cast<uint32_t>(k));
+            for (const Shape& shape : shapes) {
+                Maze maze = generator.generate(shape.kind, 40, 40, shape.density);
+                fill(maze, grid);
+                outcome.cases++;
+                const PathResult& hierarchical = Labyrinth::HierarchicalSearch(grid, maze.start, maze.end, buffers);
+                cells.assign(hierarchical.cells.begin(), hierarchical.cells.end());
+                size_t shortest = Labyrinth::BreadthFirstSearch(grid, maze.start, maze.end, buffers).cells.size();
+
+                bool valid = cells.empty() == (shortest == 0) && cells.size() >= shortest;
+                if (valid && !cells.empty())
+                    valid = cells.front() == maze.start && cells.back() == maze.end;
+                for (size_t step = 1; valid && step < cells.size(); step++) {
+                    int from = cells[step - 1], to = cells[step];
+                    int distance = std::abs(from / maze.rows - to / maze.rows) + std::abs(from % maze.rows - to % maze.rows);
+                    valid = distance == 1 && (maze.labels[to] == '.' || maze.labels[to] == 'S');
+                }
+                if (!valid) {
+                    outcome.mismatches++;
+                    reportMismatch("hierarchy", MazeGenerator::name(shape.kind, shape.density), maze,
+                                   "hierarchical path of " + std::to_string(cells.size()) + " cells, breadth-first "
+                                   + std::to_string(shortest));
+                }
+            }
+        }
+        return outcome;
+    }
+
+    // Print the outcome of a check and tell if it passed
+    bool summarize(const char* check, const Outcome& outcome) {
+        std::printf("%-24s %8lld cases %6lld mismatches\n", check, outcome.cases, outcome.mismatches);
+        return outcome.mismatches == 0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // --seed S of the generated mazes, --mazes N mazes of every shape per check
+    uint32_t seed = 1;
+    int count = 200;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--mazes" && i + 1 < argc) {
+            count = std::atoi(argv[++i]);
+        } else {
+            std::fprintf(stderr, "Usage : %s [--seed S] [--mazes N]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    bool passed = true;
+    passed = summarize("dijkstra-heap-vs-scan", checkDijkstra(seed, count)) && passed;
+    passed = summarize("escape-vs-simulation", checkEscape(seed, count)) && passed;
+    passed = summarize("decide-several-exits", checkExits(seed, count)) && passed;
+    passed = summarize("hierarchy-reused", checkHierarchy(seed, count)) && passed;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,197 @@
+#include <algorithm> // Sorting the latencies
+#include <chrono> // Timing of the queries
+#include <cstdint> // Fixed width integers
+#include <cstdio> // Output of the results
+#include <cstdlib> // Conversion of the arguments
+#include <random> // Random prisoners and fires
+#include <string> // String manipulation functions
+#include <vector> // Dynamic array functionality using vectors
+#include <sys/socket.h> // Connection to the server
+#include <sys/un.h> // UNIX socket addresses
+#include <unistd.h> // Reading and writing the socket
+
+namespace {
+    // Line oriented connection to a query server
+    class Connection {
+    public:
+        explicit Connection(int fd) : fd(fd) {}
+
+        ~Connection() {
+            if (fd >= 0)
+                close(fd);
+        }
+
+        // Send one query and wait for its answer, return false when the server is gone
+        bool ask(const std::string& query, std::string& answer) {
+            std::string line = query + "\n";
+            size_t sent = 0;
+            while (sent < line.size()) {
+                ssize_t count = write(fd, line.data() + sent, line.size() - sent);
+                if (count <= 0)
+                    return false;
+                sent += static_cast<size_t>(count);
+            }
+            answer.clear();
+            while (true) {
+                size_t end = pending.find('\n');
+                if (end != std::string::npos) {
+                    answer = pending.substr(0, end);
+                    pending.erase(0, end + 1);
+                    return true;
+                }
+                char chunk[4096];
+                ssize_t count = read(fd, chunk, sizeof(chunk));
+                if (count <= 0)
+                    return false;
+                pending.append(chunk, static_cast<size_t>(count));
+            }
+        }
+
+    private:
+        int fd; // Connected socket
+        std::string pending; // Bytes received after the last answer
+    };
+
+    // Connect to the UNIX socket at path, -1 on failure
+    int connectTo(const std::string& path) {
+        sockaddr_un address{};
+        if (path.size() >= sizeof(address.sun_path))
+            return -1;
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+            return -1;
+        address.sun_family = AF_UNIX;
+        path.copy(address.sun_path, path.size());
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    // Largest number of free cells gathered before the timed queries
+    const size_t FreeCells = 4096;
+
+    // Cell of the maze, line and column from 0
+    struct Cell {
+        int line;
+        int column;
+    };
+
+    // Latency of the given quantile in sorted samples, 0 without samples
+    long long quantile(const std::vector<long long>& sorted, double q) {
+        if (sorted.empty())
+            return 0;
+        size_t slot = static_cast<size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[slot];
+    }
+
+    // Sort the latencies of one kind of answer and print their percentiles in microseconds
+    void printLatencies(const char* kind, std::vector<long long>& latencies) {
+        std::sort(latencies.begin(), latencies.end());
+        std::printf(" %s_p50_us %.1f %s_p99_us %.1f %s_max_us %.1f", kind, quantile(latencies, 0.50) / 1e3, kind,
+                    quantile(latencies, 0.99) / 1e3, kind, quantile(latencies, 1.0) / 1e3);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // --socket path of the server, --queries N to send, --seed S of the generator
+    // --fires F distinct sets of fires, 0 to always use the fires of the maze; more sets than the cache holds cause misses
+    std::string path;
+    long long queries = 100000;
+    int fireSets = 0;
+    uint32_t seed = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--socket" && i + 1 < argc) {
+            path = argv[++i];
+        } else if (arg == "--queries" && i + 1 < argc) {
+            queries = std::atoll(argv[++i]);
+        } else if (arg == "--fires" && i + 1 < argc) {
+            fireSets = std::atoi(argv[++i]);
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else {
+            std::fprintf(stderr, "Usage : %s --socket path [--queries N] [--fires F] [--seed S]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (path.empty() || queries < 1 || fireSets < 0) {
+        std::fprintf(stderr, "Error : --socket is required, --queries must be at least 1 and --fires not negative.\n");
+        return EXIT_FAILURE;
+    }
+
+    int fd = connectTo(path);
+    if (fd < 0) {
+        std::fprintf(stderr, "Error : cannot connect to %s.\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+    Connection connection(fd);
+    std::string answer;
+    int lines = 0, rows = 0;
+    if (!connection.ask("info", answer) || std::sscanf(answer.c_str(), "%d %d", &lines, &rows) != 2 || lines < 1 || rows < 1) {
+        std::fprintf(stderr, "Error : unexpected answer to info.\n");
+        return EXIT_FAILURE;
+    }
+
+    // Free cells, found by untimed queries with the fires of the maze: walls, fires and exits are answered with an error.
+    // The prisoners and the single-cell fires are drawn among them, so that the timed queries measure searches
+    std::mt19937 generator(seed);
+    std::vector<Cell> cells;
+    size_t wanted = std::min(FreeCells, static_cast<size_t>(lines) * static_cast<size_t>(rows));
+    for (size_t probe = 0; probe < 64 * FreeCells && cells.size() < wanted; probe++) {
+        Cell cell = {static_cast<int>(generator() % lines), static_cast<int>(generator() % rows)};
+        if (!connection.ask("escape " + std::to_string(cell.line) + " " + std::to_string(cell.column), answer)) {
+            std::fprintf(stderr, "Error : the server closed the connection.\n");
+            return EXIT_FAILURE;
+        }
+        if (!answer.empty() && answer[0] != 'E')
+            cells.push_back(cell);
+    }
+    if (cells.empty()) {
+        std::fprintf(stderr, "Error : no free cell found in the maze.\n");
+        return EXIT_FAILURE;
+    }
+    std::vector<Cell> fires;
+    for (int f = 0; f < fireSets; f++)
+        fires.push_back(cells[generator() % cells.size()]);
+
+    // Latencies of the searches (Y or N) and of the errors apart, an error is answered before any search
+    std::vector<long long> latencies, errorLatencies;
+    latencies.reserve(static_cast<size_t>(queries));
+    long long escapes = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (long long q = 0; q < queries; q++) {
+        Cell prisoner = cells[generator() % cells.size()];
+        std::string query = "escape " + std::to_string(prisoner.line) + " " + std::to_string(prisoner.column);
+        if (!fires.empty()) {
+            // A prisoner standing on the fire is answered with an error, counted apart
+            const Cell& fire = fires[generator() % fires.size()];
+            query += " fires " + std::to_string(fire.line) + "," + std::to_string(fire.column);
+        }
+        auto start = std::chrono::steady_clock::now();
+        if (!connection.ask(query, answer)) {
+            std::fprintf(stderr, "Error : the server closed the connection.\n");
+            return EXIT_FAILURE;
+        }
+        auto end = std::chrono::steady_clock::now();
+        long long latency = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        if (answer.empty() || answer[0] == 'E') {
+            errorLatencies.push_back(latency);
+        } else {
+            latencies.push_back(latency);
+            // "Y moves": the moves follow the latest safe turns from the exits, a safe escape but not always the shortest
+            escapes += answer[0] == 'Y';
+        }
+    }
+    auto finish = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(finish - begin).count();
+
+    std::printf("queries %lld free_cells %zu escapes %lld errors %zu", queries, cells.size(), escapes, errorLatencies.size());
+    printLatencies("search", latencies);
+    printLatencies("error", errorLatencies);
+    std::printf(" queries_per_second %.0f\n", seconds > 0 ? queries / seconds : 0.0);
+    if (connection.ask("stats", answer))
+        std::printf("server %s\n", answer.c_str());
+    return EXIT_SUCCESS;
+}
@@ -3,29 +3,257 @@
 #include <string> // String manipulation functions
 #include <limits> // Numeric limits and error handling
 #include <sstream> // String stream functionality for parsing
+#include <cstdio> // Buffered output of the batch results
+#include <cstdlib> // Exit status codes
+#include <fcntl.h> // Opening the batch input file
+#include <unistd.h> // Terminal detection and file descriptors
 #include "Labyrinth.h" // Include the declaration of the Labyrinth class
+#include "BatchReader.h" // Include the declaration of the BatchReader class
+#include "ParallelSolver.h" // Include the declaration of the ParallelSolver class
+#include "QueryServer.h" // Include the declaration of the QueryServer class
+#include "MazeCorpus.h" // Include the declaration of the MazeCorpus class
+#include "BatchPipeline.h" // Include the declaration of the BatchPipeline class
+#include <thread> // Number of hardware threads
 
-bool isCharAlreadyPresent(char** labyrinth, int row, int m, char target) {
-    // Check if a character is already present in a given row
-    for (int k = 0; k < m; k++) {
-        // Check if the target character is present in the current row
-        if (labyrinth[row][k] == target) {
-            return true;
+int runBatch(int fd, int threads, bool withStats, bool pipelined) {
+    // Read every instance from the file descriptor and print one result per line, nothing else
+    // A line holds one 'Y' or 'N' per prisoner of the instance, in the order of their cells
+    // With statistics, one JSON line per instance is written to the standard error
+    BatchReader reader(fd);
+    long long instances = 0;
+    if (!reader.readInt(instances) || instances <= 0) {
+        std::cerr << "Error : invalid number of instances." << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // Several threads and instances: solve in a worker pool, the results keep the input order
+    if (threads > 1 && instances > 1) {
+        std::string error;
+        ParallelSolver solver(threads, stdout, withStats ? stderr : nullptr);
+        if (!solver.run(reader, instances, error)) {
+            std::cerr << "Error : " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Pipeline: reading, solving and writing overlap, a single instance with several threads is searched by the parallel engine
+    // With statistics, the counters of the three stages follow the lines of the instances
+    if (pipelined) {
+        std::string error;
+        ParallelBfs engine(threads);
+        BatchPipeline pipeline(stdout, withStats ? stderr : nullptr, threads > 1 ? &engine : nullptr);
+        bool valid = pipeline.run(reader, instances, error);
+        if (withStats) {
+            std::cerr << pipeline.reader().toJson("reader", "free") << '\n'
+                      << pipeline.solver().toJson("solver", "parsed") << '\n'
+                      << pipeline.writer().toJson("writer", "solved") << std::endl;
+        }
+        if (!valid) {
+            std::cerr << "Error : " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        return EXIT_SUCCESS;
+    }
+
+    // Grid, search buffers and output buffer are reused by every instance
+    // A single instance with several threads is searched by the parallel engine
+    // Giant instances are read into a packed grid, 4 bits per cell, instead
+    Labyrinth::GridGraph grid;
+    PackedGrid packed;
+    Labyrinth::SearchBuffers buffers;
+    ParallelBfs engine(threads);
+    if (threads > 1)
+        buffers.parallel = &engine;
+    SolverStats stats;
+    if (withStats)
+        buffers.stats = &stats;
+    std::string out, statsOut, result;
+    out.reserve(1 << 16);
+    std::string error;
+
+    for (long long i = 0; i < instances; i++) {
+        int startV = 0, endV = 0;
+        long long n = 0, m = 0;
+        bool giant = false;
+        bool valid = reader.readDimensions(n, m, error);
+        if (valid) {
+            giant = n * m >= PackedGrid::MinimumCells;
+            valid = giant ? reader.readRows(packed, n, m, error) : reader.readRows(grid, n, m, startV, endV, error);
         }
+        if (!valid) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fwrite(statsOut.data(), 1, statsOut.size(), stderr);
+            std::cerr << "Error : " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+
+        // Decide the instance and queue the result
+        stats.clear();
+        if (giant)
+            result.assign(1, packed.escapeDecision(nullptr, buffers.stats));
+        else
+            Labyrinth::decideInstance(grid, reader.prisoners(), reader.exits(), startV, endV, buffers, result);
+        out += result;
+        out += '\n';
+        if (withStats) {
+            statsOut += stats.toJson(i + 1, result);
+            statsOut += '\n';
+        }
+        if (out.size() >= (1 << 16) || statsOut.size() >= (1 << 16)) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fwrite(statsOut.data(), 1, statsOut.size(), stderr);
+            out.clear();
+            statsOut.clear();
+        }
+    }
+
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    std::fwrite(statsOut.data(), 1, statsOut.size(), stderr);
+    std::fflush(stdout);
+    return EXIT_SUCCESS;
+}
+
+int runConvert(const char* textPath, const char* corpusPath, bool runLength, bool withAnswers) {
+    // Copy every instance of a text batch file into a binary corpus, with the answers of the solver when asked
+    int fd = open(textPath, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error : cannot open " << textPath << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    BatchReader reader(fd);
+    MazeCorpusWriter writer;
+    Labyrinth::GridGraph grid;
+    Labyrinth::SearchBuffers buffers;
+    std::string error = "invalid number of instances.", result;
+    long long instances = 0;
+    bool valid = reader.readInt(instances) && instances > 0 && writer.open(corpusPath, error);
+    for (long long i = 0; valid && i < instances; i++) {
+        // The corpus numbers the cells of a grid by 32 bits and unpacks them into a GridGraph: the giant instances of the
+        // batch mode, decided on a packed grid, are refused before their rows are read
+        int startV = 0, endV = 0;
+        long long n = 0, m = 0;
+        valid = reader.readDimensions(n, m, error);
+        if (valid && n * m >= PackedGrid::MinimumCells) {
+            error = "instance " + std::to_string(i + 1) + " has " + std::to_string(n * m)
+                    + " cells, --convert does not support the instances of 2^24 cells or more, decide them with --batch.";
+            valid = false;
+        }
+        valid = valid && reader.readRows(grid, n, m, startV, endV, error);
+        if (valid && withAnswers)
+            Labyrinth::decideInstance(grid, reader.prisoners(), reader.exits(), startV, endV, buffers, result);
+        valid = valid && writer.add(grid, withAnswers ? &result : nullptr, runLength, error);
+    }
+    close(fd);
+    if (!valid || !writer.finish(error)) {
+        std::cerr << "Error : " << error << std::endl;
+        std::remove(corpusPath); // No partial corpus is left behind
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int runCorpus(const char* corpusPath, int threads, bool withStats) {
+    // Decide every instance of a binary corpus and print one result per line, as the batch mode does
+    // Instances with a stored answer are checked against it, every difference is reported on the standard error
+    MazeCorpus corpus;
+    std::string error;
+    if (!corpus.open(corpusPath, error)) {
+        std::cerr << "Error : " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    Labyrinth::GridGraph grid;
+    Labyrinth::SearchBuffers buffers;
+    ParallelBfs engine(threads);
+    if (threads > 1)
+        buffers.parallel = &engine;
+    SolverStats stats;
+    if (withStats)
+        buffers.stats = &stats;
+    std::string out, statsOut, result;
+    out.reserve(1 << 16);
+    long long mismatches = 0;
+
+    for (uint64_t k = 0; k < corpus.size(); k++) {
+        // The prisoners and exits are read from the record, the grid is never scanned for them
+        MazeCorpus::Instance instance;
+        if (!corpus.instance(k, instance, error) || !instance.unpack(grid, error)) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fwrite(statsOut.data(), 1, statsOut.size(), stderr);
+            std::cerr << "Error : instance " << k + 1 << " : " << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        stats.clear();
+        Labyrinth::decideInstance(grid, instance.header->prisoners, instance.header->exits,
+                                  static_cast<int>(instance.prisoners[0]), static_cast<int>(instance.exits[0]), buffers, result);
+        if (instance.answer != nullptr && result.compare(0, std::string::npos, instance.answer, instance.header->answerLength) != 0) {
+            mismatches++;
+            std::cerr << "Mismatch : instance " << k + 1 << " : expected "
+                      << std::string(instance.answer, instance.header->answerLength) << ", got " << result << std::endl;
+        }
+        out += result;
+        out += '\n';
+        if (withStats) {
+            statsOut += stats.toJson(static_cast<long long>(k) + 1, result);
+            statsOut += '\n';
+        }
+        if (out.size() >= (1 << 16) || statsOut.size() >= (1 << 16)) {
+            std::fwrite(out.data(), 1, out.size(), stdout);
+            std::fwrite(statsOut.data(), 1, statsOut.size(), stderr);
+            out.clear();
+            statsOut.clear();
+        }
+    }
+
+    std::fwrite(out.data(), 1, out.size(), stdout);
+    std::fwrite(statsOut.data(), 1, statsOut.size(), stderr);
+    std::fflush(stdout);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+int runServer(const char* mazePath, const char* socketPath, long long cacheMegabytes) {
+    // Load the first instance of the maze file once, then answer queries until the input ends
+    int fd = open(mazePath, O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error : cannot open " << mazePath << "." << std::endl;
+        return EXIT_FAILURE;
+    }
+    BatchReader reader(fd);
+    Labyrinth::GridGraph maze;
+    long long instances = 0;
+    int startV = 0, endV = 0;
+    std::string error = "invalid number of instances.";
+    bool valid = reader.readInt(instances) && instances > 0 && reader.readInstance(maze, startV, endV, error);
+    close(fd);
+    if (!valid) {
+        std::cerr << "Error : " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    QueryServer server(maze, static_cast<size_t>(cacheMegabytes) << 20);
+    if (socketPath == nullptr) {
+        server.serveStream(stdin, stdout);
+        return EXIT_SUCCESS;
     }
-    // Return false if the target character is not found in the row
-    return false;
+    if (!server.serveSocket(socketPath, error)) {
+        std::cerr << "Error : " << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
 }
 
-int main() {
-    std::vector<char> res;
+int runInteractive(bool withStats) {
+    std::vector<std::string> res;
     int instances;
 
     // Ask the user to enter the number of instances without allowing spaces
     while (true) {
         std::cout << "Enter the number of instances : ";
         std::string input;
-        std::getline(std::cin, input);
+        if (!std::getline(std::cin, input)) {
+            std::cerr << "\nError : Unexpected end of input." << std::endl;
+            return EXIT_FAILURE;
+        }
 
         // Check for spaces and non-numeric characters in the input
         if (input.find_first_not_of("0123456789") == std::string::npos) {
@@ -45,9 +273,15 @@ int main() {
         }
     }
 
-    char** labyrinth;
     int n = 0, m = 0;
 
+    // Grid and search scratch state shared by all instances, refilled in place
+    Labyrinth::GridGraph grid;
+    Labyrinth::SearchBuffers buffers;
+    SolverStats stats;
+    if (withStats)
+        buffers.stats = &stats;
+
     // Process labyrinth instances
     for (int i = 0; i < instances; i++) {
         // Ask the user to enter the labyrinth dimensions for the current instance
@@ -55,6 +289,10 @@ int main() {
             std::cout << "Enter the dimensions of the labyrinth for instance " << i + 1 << " (1-1000) (n m) : ";
             std::cin >> n >> m;
 
+            if (std::cin.eof()) {
+                std::cerr << "\nError : Unexpected end of input." << std::endl;
+                return EXIT_FAILURE;
+            }
             if (std::cin.fail() || n < 1 || m < 1 || n > 1000 || m > 1000) {
                 std::cin.clear();  // Clearing the error flag
                 std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');  // Discarding invalid input
@@ -64,15 +302,14 @@ int main() {
             }
         }
 
-        labyrinth = new char*[n];
-        bool hasD = false, hasF = false, hasS = false;
-
-        // Allocate memory for the labyrinth based on user input for dimensions
+        // Reuse the grid of the previous instance for the new dimensions
         // Initialize variables to track occurrences of characters D, F, and S
+        grid.reset(n, m);
+        bool hasF = false;
+        int prisoners = 0, exits = 0;
+        int startV = -1, endV = -1;
 
         for (int j = 0; j < n; j++) {
-            labyrinth[j] = new char[m];
-
             while (true) {
                 // Ask the user to enter row data for the current instance
                 std::string row;
@@ -80,36 +317,34 @@ int main() {
                 std::cin >> row;
 
                 // Validate user input for the labyrinth row
-                if (row.length() != static_cast<size_t>(m) || std::cin.fail()) {
+                if (std::cin.eof() && row.empty()) {
+                    std::cerr << "\nError : Unexpected end of input." << std::endl;
+                    return EXIT_FAILURE;
+                }
+                // Only walls, D, F, S and the terrain symbols are accepted, as in the batch mode
+                if (row.length() != static_cast<size_t>(m) || std::cin.fail()
+                    || row.find_first_not_of("#DFS.~=%123456789") != std::string::npos) {
                     std::cin.clear();
                     std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
                     std::cerr << "\nInvalid input for labyrinth row. Please try again." << std::endl;
                 } else {
-                    // Check if D, F, or S are already present in the row
-                    if (isCharAlreadyPresent(labyrinth, j, m, 'D') && row.find('D') != std::string::npos) {
-                        std::cerr << "\nError : Only one 'D' is allowed. Please try again." << std::endl;
-                        continue;
-                    }
-
-                    if (isCharAlreadyPresent(labyrinth, j, m, 'F') && row.find('F') != std::string::npos) {
-                        std::cerr << "\nError : Only one 'F' is allowed. Please try again." << std::endl;
-                        continue;
-                    }
-
-                    if (isCharAlreadyPresent(labyrinth, j, m, 'S') && row.find('S') != std::string::npos) {
-                        std::cerr << "\nError : Only one 'S' is allowed. Please try again." << std::endl;
-                        continue;
-                    }
-
-                    // Create a new const char* and copy the data
-                    const char* constRow = row.c_str();
+                    // Copy the row into the grid and identify the first start (D) and end (S) vertices
+                    // Any number of prisoners, fires and exits is accepted
                     for (int k = 0; k < m; k++) {
-                        labyrinth[j][k] = constRow[k];
+                        grid.setCell(j * m + k, row[k]);
 
                         // Update the variables to track occurrences
-                        if (labyrinth[j][k] == 'D') hasD = true;
-                        if (labyrinth[j][k] == 'F') hasF = true;
-                        if (labyrinth[j][k] == 'S') hasS = true;
+                        if (row[k] == 'D') {
+                            prisoners++;
+                            if (startV == -1)
+                                startV = j * m + k;
+                        }
+                        if (row[k] == 'F') hasF = true;
+                        if (row[k] == 'S') {
+                            exits++;
+                            if (endV == -1)
+                                endV = j * m + k;
+                        }
                     }
 
                     break;  // Exit the loop if the input is valid
@@ -117,76 +352,114 @@ int main() {
             }
         }
 
-        // Check that there is only one occurrence of D, F, and S
-        if (!hasD || !hasF || !hasS) {
-            std::cerr << "\nError : Each instance must have one 'D', one 'F', and one 'S'. Please try again." << std::endl;
-
-            // Clean up memory
-            for (int j = 0; j < n; j++) {
-                delete[] labyrinth[j];
-            }
-            delete[] labyrinth;
+        // Check that there is at least one occurrence of D, F, and S
+        if (prisoners == 0 || !hasF || endV == -1) {
+            std::cerr << "\nError : Each instance must have at least one 'D', one 'F', and one 'S'. Please try again." << std::endl;
 
             // Decrement the instance counter to re-enter the input for the same instance
             i--;
             continue;  // Skip the rest of the loop and start the next iteration
         }
 
-        // Create the graph representing the labyrinth
-        Labyrinth::Graph graph;
-        int startV = 0, endV = 0;
-
-        // Populate the graph with vertices and identify the start (D) and end (S) vertices
-        for (int j = 0; j < n; j++) {
-            for (int k = 0; k < m; k++) {
-                graph.addVertex(labyrinth[j][k], 1, j, k);
-                if (labyrinth[j][k] == 'D')
-                    startV = j * m + k;
-                if (labyrinth[j][k] == 'S')
-                    endV = j * m + k;
-            }
-        }
+        // Decide the instance and add the result to the list, one character per prisoner
+        stats.clear();
+        res.push_back(std::string());
+        Labyrinth::decideInstance(grid, prisoners, exits, startV, endV, buffers, res.back());
+        if (withStats)
+            std::cerr << stats.toJson(i + 1, res.back()) << std::endl;
+    }
 
-        // Add edges to the graph
-        for (int row = 0; row < n; row++) {
-            for (int col = 0; col < m; col++) {
-                int startVertex = row * m + col;
-                int destination;
-                double weight;
-
-                // Traverse direct and diagonal neighbors
-                for (int y = -1; y <= 1; y++) {
-                    for (int j = -1; j <= 1; j++) {
-                        if ((y != 0) || (j != 0)) { // Exclude the vertex itself
-                            // Check grid boundaries
-                            if ((row + y) >= 0 && (row + y) < n && (col + j) >= 0 && (col + j) < m) {
-                                destination = (row + y) * m + col + j;
-                                weight = 1;
-
-                                // Add the edge if it is horizontal or vertical
-                                if (std::abs(startVertex - destination) == 1 || std::abs(startVertex - destination) == m)
-                                    graph.addEdge(startVertex, destination, weight);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    // Display the result(s)
+    std::cout << "Result(s) :" << std::endl;
+    for (const std::string& result : res)
+        std::cout << result << std::endl;
 
-        // Execute the instance and add the result to the list
-        res.push_back(Labyrinth::runInstance(graph, startV, endV, n, m));
+    return EXIT_SUCCESS;
+}
 
-        // Memory cleanup
-        for (int j = 0; j < n; j++) {
-            delete[] labyrinth[j];
+int main(int argc, char* argv[]) {
+    // Batch mode is chosen with --batch [file] or when the standard input is not a terminal
+    // --interactive forces the prompts even when the input is redirected
+    // --threads N solves the batch instances with N worker threads, 0 for one per hardware thread
+    // --stats writes the statistics of every solve to the standard error as JSON lines
+    // --pipeline reads, solves and writes the batch instances on three threads linked by lock-free rings
+    // --serve maze answers query lines about one maze on the standard input, or on a UNIX socket with --socket path,
+    // --cache-mb N bounds the memory of its cached fields
+    // --convert text corpus writes the instances of a text file into a binary corpus, --rle stores the cells as runs
+    // when they are smaller, --answers stores the result of every instance; --corpus file decides the instances of a corpus
+    bool batch = !isatty(STDIN_FILENO);
+    bool withStats = false;
+    const char* path = nullptr;
+    const char* mazePath = nullptr;
+    const char* socketPath = nullptr;
+    const char* textPath = nullptr;
+    const char* corpusPath = nullptr;
+    bool convert = false, runLength = false, withAnswers = false, pipelined = false;
+    long long cacheMegabytes = static_cast<long long>(QueryServer::DefaultBudget >> 20);
+    int threads = 1;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--batch") {
+            batch = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-')
+                path = argv[++i];
+        } else if (arg == "--interactive") {
+            batch = false;
+        } else if (arg == "--serve" && i + 1 < argc) {
+            mazePath = argv[++i];
+        } else if (arg == "--socket" && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (arg == "--cache-mb" && i + 1 < argc) {
+            cacheMegabytes = std::atoll(argv[++i]);
+            if (cacheMegabytes < 0)
+                cacheMegabytes = 0;
+        } else if (arg == "--convert" && i + 2 < argc) {
+            convert = true;
+            textPath = argv[++i];
+            corpusPath = argv[++i];
+        } else if (arg == "--rle") {
+            runLength = true;
+        } else if (arg == "--answers") {
+            withAnswers = true;
+        } else if (arg == "--corpus" && i + 1 < argc) {
+            corpusPath = argv[++i];
+        } else if (arg == "--stats") {
+            withStats = true;
+        } else if (arg == "--pipeline") {
+            pipelined = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+            if (threads <= 0)
+                threads = static_cast<int>(std::thread::hardware_concurrency());
+        } else {
+            std::cerr << "Usage : " << argv[0] << " [--batch [file]] [--interactive] [--threads N] [--stats] [--pipeline]"
+                      << " | --serve maze [--socket path] [--cache-mb N]"
+                      << " | --convert text corpus [--rle] [--answers] | --corpus file [--threads N] [--stats]" << std::endl;
+            return EXIT_FAILURE;
         }
-        delete[] labyrinth;
     }
 
-    // Display the result(s)
-    std::cout << "Result(s) :" << std::endl;
-    for (char c : res)
-        std::cout << c << std::endl;
+    if (mazePath != nullptr)
+        return runServer(mazePath, socketPath, cacheMegabytes);
+    if (convert)
+        return runConvert(textPath, corpusPath, runLength, withAnswers);
+    if (corpusPath != nullptr)
+        return runCorpus(corpusPath, threads, withStats);
 
-    return EXIT_SUCCESS;
+    if (!batch)
+        return runInteractive(withStats);
+
+    // Read the given file, or the standard input
+    int fd = STDIN_FILENO;
+    if (path != nullptr) {
+        fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "Error : cannot open " << path << "." << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    int status = runBatch(fd, threads, withStats, pipelined);
+    if (fd != STDIN_FILENO)
+        close(fd);
+    return status;
 }